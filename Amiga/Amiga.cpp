@@ -89,6 +89,8 @@ Amiga::Amiga()
         &joystick1,
         &joystick2,
         &keyboard,
+        &inputRecorder,
+        &automator,
         &df0,
         &df1,
         &df2,
@@ -146,13 +148,7 @@ Amiga::clearInspectionTarget()
 AmigaInfo
 Amiga::getInfo()
 {
-    AmigaInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 AmigaConfiguration
@@ -163,6 +159,7 @@ Amiga::getConfig()
     config.rtc = rtc.getConfig();
     config.audio = paula.audioUnit.getConfig();
     config.mem = mem.getConfig();
+    config.zorro = zorro.getConfig();
     config.agnus = agnus.getConfig();
     config.denise = denise.getConfig();
     config.serialPort = serialPort.getConfig();
@@ -204,6 +201,8 @@ Amiga::updateStats()
     stats.frames++;
 
     pthread_mutex_unlock(&lock);
+
+    recordFrameCounters();
 }
 
 void
@@ -219,6 +218,31 @@ Amiga::clearStats()
     paula.diskController.clearStats();
 }
 
+bool
+Amiga::getFrameCounters(long frame, FrameCounters &result)
+{
+    return counterRing.read(frame, result);
+}
+
+bool
+Amiga::getLatestFrameCounters(FrameCounters &result)
+{
+    return counterRing.readLatest(result);
+}
+
+void
+Amiga::recordFrameCounters()
+{
+    uint64_t now = time_in_nanos();
+
+    counters.frame = counterRing.count();
+    counters.hostNanos = frameStart ? (long)(now - frameStart) : 0;
+    counterRing.write(counters);
+
+    memset(&counters, 0, sizeof(counters));
+    frameStart = now;
+}
+
 bool
 Amiga::configure(ConfigOption option, long value)
 {
@@ -284,14 +308,8 @@ Amiga::configure(ConfigOption option, long value)
         
         case VA_FAST_RAM:
             
-            if ((value % 64) != 0 || value > 8192) {
-                warn("Invalid Fast Ram size: %d\n", value);
-                warn("Valid values: 0KB, 64KB, 128KB, ..., 8192KB (8MB)\n");
-                return false;
-            }
-            
-            mem.allocFast(KB(value));
-            break;
+            // Configures the first Zorro II board
+            return configureBoard(0, option, value);
 
         case VA_EXT_START:
 
@@ -352,11 +370,23 @@ Amiga::configure(ConfigOption option, long value)
             paula.audioUnit.setFilterType((FilterType)value);
             break;
 
+        case VA_BAND_LIMITING:
+
+            if (current.audio.bandLimiting == value) return true;
+            paula.audioUnit.setBandLimiting(value);
+            break;
+
         case VA_BLITTER_ACCURACY:
             
             if (current.blitter.accuracy == value) return true;
             agnus.blitter.setAccuracy(value);
             break;
+
+        case VA_BLITTER_HYBRID:
+
+            if (current.blitter.hybrid == value) return true;
+            agnus.blitter.setHybrid(value);
+            break;
             
         case VA_FIFO_BUFFERING:
 
@@ -441,6 +471,105 @@ Amiga::configureDrive(unsigned drive, ConfigOption option, long value)
     return true;
 }
 
+bool
+Amiga::configureBoard(unsigned board, ConfigOption option, long value)
+{
+    if (board >= ZORRO_BOARDS) {
+        warn("Invalid board number: %d\n", board);
+        return false;
+    }
+
+    ZorroConfig current = getConfig().zorro;
+
+    switch (option) {
+
+        case VA_FAST_RAM:
+
+            if (!isValidBoardSize(KB(value))) {
+                warn("Invalid Fast Ram size: %d\n", value);
+                warn("Valid values: 0KB, 64KB, 128KB, 256KB, ..., 8192KB (8MB)\n");
+                return false;
+            }
+
+            if (current.boardSize[board] == (size_t)KB(value)) return true;
+            if (!zorro.setBoardSize(board, KB(value))) return false;
+            break;
+
+        default: assert(false);
+    }
+
+    putMessage(MSG_CONFIG);
+    return true;
+}
+
+Amiga *
+Amiga::clone()
+{
+    AmigaConfiguration config = getConfig();
+    bool success = true;
+
+    suspend();
+
+    Amiga *result = new Amiga();
+
+    // Apply the configuration
+    result->configure(VA_AGNUS_REVISION, config.agnus.revision);
+    result->configure(VA_DENISE_REVISION, config.denise.revision);
+    result->configure(VA_RT_CLOCK, config.rtc.model);
+    result->configure(VA_CHIP_RAM, config.mem.chipSize / 1024);
+    result->configure(VA_SLOW_RAM, config.mem.slowSize / 1024);
+    for (unsigned i = 0; i < ZORRO_BOARDS; i++)
+        result->configureBoard(i, VA_FAST_RAM, config.zorro.boardSize[i] / 1024);
+    result->configure(VA_EXT_START, config.mem.extStart);
+    result->configure(VA_EMULATE_SPRITES, config.denise.emulateSprites);
+    result->configure(VA_CLX_SPR_SPR, config.denise.clxSprSpr);
+    result->configure(VA_CLX_SPR_PLF, config.denise.clxSprPlf);
+    result->configure(VA_CLX_PLF_PLF, config.denise.clxPlfPlf);
+    result->configure(VA_FILTER_ACTIVATION, config.audio.filterActivation);
+    result->configure(VA_FILTER_TYPE, config.audio.filterType);
+    result->configure(VA_BAND_LIMITING, config.audio.bandLimiting);
+    result->configure(VA_BLITTER_ACCURACY, config.blitter.accuracy);
+    result->configure(VA_BLITTER_HYBRID, config.blitter.hybrid);
+    result->configure(VA_FIFO_BUFFERING, config.diskController.useFifo);
+    result->configure(VA_SERIAL_DEVICE, config.serialPort.device);
+    result->configure(VA_DRIVE_SPEED, config.df0.speed);
+    result->paula.audioUnit.setSampleRate(config.audio.sampleRate);
+
+    DriveConfig *drive[4] = { &config.df0, &config.df1, &config.df2, &config.df3 };
+    for (unsigned i = 0; i < 4; i++) {
+        result->configureDrive(i, VA_DRIVE_CONNECT, config.diskController.connected[i]);
+        result->configureDrive(i, VA_DRIVE_TYPE, drive[i]->type);
+    }
+
+    // Share the Roms
+    result->mem.cloneRoms(mem);
+
+    // Power up the new instance
+    if (isPoweredOn()) result->powerOn();
+
+    // Transfer the internal state (except the memory contents)
+    mem.serializeContents = result->mem.serializeContents = false;
+
+    vector<uint8_t> buffer(size());
+    save(buffer.data());
+    result->load(buffer.data());
+
+    mem.serializeContents = result->mem.serializeContents = true;
+
+    // Duplicate the memory contents
+    success = result->mem.cloneRam(mem);
+
+    resume();
+
+    if (!success) {
+        delete result;
+        return NULL;
+    }
+
+    result->inspect();
+    return result;
+}
+
 void
 Amiga::prefix()
 {
@@ -552,6 +681,9 @@ Amiga::_run()
 {
     debug(RUNLOOP_DEBUG, "Starting emulation thread (PC = %X)\n", cpu.getPC());
 
+    // Don't charge the time spent in pause mode to the current frame
+    frameStart = 0;
+
     // Start the emulator thread
     pthread_create(&p, NULL, threadMain, (void *)this);
     
@@ -584,9 +716,6 @@ Amiga::_ping()
 void
 Amiga::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     info.cpuClock = cpu.getMasterClock();
     info.dmaClock = agnus.clock;
     info.ciaAClock = ciaA.clock;
@@ -594,8 +723,8 @@ Amiga::_inspect()
     info.frame = agnus.frame;
     info.vpos = agnus.pos.v;
     info.hpos = agnus.pos.h;
-    
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void
@@ -643,6 +772,9 @@ Amiga::suspend()
 {
     debug(2, "Suspending (%d)...\n", suspendCounter);
     
+    if (isEmulatorThread())
+    return;
+
     if (suspendCounter == 0 && !isRunning())
     return;
     
@@ -655,6 +787,9 @@ Amiga::resume()
 {
     debug(2, "Resuming (%d)...\n", suspendCounter);
     
+    if (isEmulatorThread())
+    return;
+
     if (suspendCounter == 0)
     return;
     
@@ -948,12 +1083,23 @@ Amiga::runLoop()
         cpu.debugger.disableLogging();
     }
     agnus.scheduleRel<INS_SLOT>(0, inspectionTarget);
-    
+
+#ifdef HOST_PROFILER
+    profiler.clear();
+#endif
+
     // Enter the loop
     do {
         
         // Emulate the next CPU instruction
+#ifdef HOST_PROFILER
+        profiler.enter(PS_CPU);
         cpu.execute();
+        profiler.leave();
+#else
+        cpu.execute();
+#endif
+        counters.cpuInstructions++;
 
         // Check if special action needs to be taken
         if (runLoopCtrl) {
@@ -997,8 +1143,34 @@ Amiga::runLoop()
         }
         
     } while (1);
+
+#ifdef HOST_PROFILER
+    dumpProfile();
+#endif
+}
+
+#ifdef HOST_PROFILER
+
+void
+Amiga::dumpProfile()
+{
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/vAmiga-%d-%ld.folded", getpid(), ++profiledRuns);
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        warn("Can't write profiler report to %s\n", path);
+        return;
+    }
+
+    profiler.dump(file);
+    fclose(file);
+
+    msg("Profiler report written to %s\n", path);
 }
 
+#endif
+
 void
 Amiga::dumpClock()
 {
@@ -14,6 +14,8 @@
 #include "AmigaComponent.h"
 #include "Serialization.h"
 #include "MessageQueue.h"
+#include "FrameCounterRing.h"
+#include "Profiler.h"
 
 // Sub components
 #include "CPU.h"
@@ -32,6 +34,8 @@
 #include "Mouse.h"
 #include "Joystick.h"
 #include "Keyboard.h"
+#include "InputRecorder.h"
+#include "Automator.h"
 #include "Drive.h"
 #include "Disk.h"
 
@@ -54,10 +58,40 @@ class Amiga : public HardwareComponent {
     // Information shown in the GUI inspector panel
     AmigaInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<AmigaInfo> infoBuffer;
+
     // Information shown in the GUI monitor panel
     AmigaStats stats;
 
+    // Performance counters of the most recently finished frames
+    FrameCounterRing<64> counterRing;
+
+    // Host time stamp of the beginning of the current frame
+    uint64_t frameStart = 0;
+
+public:
+
+#ifdef HOST_PROFILER
+    // Host time profiler (see Profiler.h)
+    Profiler profiler;
+
+private:
+
+    // Number of profiled runs
+    long profiledRuns = 0;
+
+    // Writes the profiler report of the current run into a file
+    void dumpProfile();
+
 public:
+#endif
+
+    /* Performance counters of the current frame
+     * The counters are incremented by the various components and moved into
+     * the counter ring at the end of each frame.
+     */
+    FrameCounters counters = { };
 
     /* Inspection target
      * To update the GUI periodically, the emulator schedules this event in the
@@ -127,6 +161,12 @@ public:
     
     // Keyboard
     Keyboard keyboard = Keyboard(*this);
+
+    // Recorder for deterministic input replays
+    InputRecorder inputRecorder = InputRecorder(*this);
+
+    // Script interpreter for automated test runs
+    Automator automator = Automator(*this);
     
     // Internal floppy drive
     Drive df0 = Drive(0, *this);
@@ -261,6 +301,21 @@ public:
     // Changes the configuration
     bool configure(ConfigOption option, long value);
     bool configureDrive(unsigned drive, ConfigOption option, long value);
+    bool configureBoard(unsigned board, ConfigOption option, long value);
+
+
+    //
+    // Cloning
+    //
+
+    /* Creates an independent copy of this Amiga
+     * The new instance has the same configuration and the same internal state
+     * and is returned in paused state. The state is transferred directly
+     * without creating a snapshot. The Roms are shared with this instance and
+     * the Ram contents are duplicated copy-on-write, i.e., a memory page is
+     * copied on the first write access. Returns NULL on failure.
+     */
+    Amiga *clone();
 
 
     //
@@ -306,6 +361,23 @@ public:
     // Clears all previously recorded statistical information
     void clearStats();
 
+    /* Returns the performance counters of a finished frame
+     * These functions are thread-safe and can be called while the emulator
+     * is running. They return false if the requested frame is not available.
+     */
+    bool getFrameCounters(long frame, FrameCounters &result);
+    bool getLatestFrameCounters(FrameCounters &result);
+
+    // Returns the number of frames recorded so far
+    long getFrameCounterCount() { return counterRing.count(); }
+
+private:
+
+    // Moves the counters of the current frame into the counter ring
+    void recordFrameCounters();
+
+public:
+
     //
     // Accessing properties
     //
@@ -353,10 +425,15 @@ public:
      *            do something with the internal state;
      *            resume();
      *
-     *  It it safe to nest multiple suspend() / resume() blocks.
+     *  It it safe to nest multiple suspend() / resume() blocks. If the
+     *  functions are called from inside the emulator thread, they have no
+     *  effect, because the internal state is consistent anyway.
      */
     void suspend();
     void resume();
+
+    // Returns true if the caller is running in the emulator thread
+    bool isEmulatorThread() { return p && pthread_equal(p, pthread_self()); }
     
     /* Sets or clears a run loop control flag
      * The functions are thread-safe and can be called from inside or outside
@@ -395,6 +472,9 @@ public:
     // Writes a notification message into message queue
     void putMessage(MessageType msg, uint64_t data = 0) { queue.putMessage(msg, data); }
     
+    // Returns the message queue statistics
+    MessageQueueStats getMessageQueueStats() { return queue.getStats(); }
+    
     
     //
     // Running the emulator
@@ -15,11 +15,14 @@
 #include "PaulaTypes.h"
 #include "CPUTypes.h"
 #include "MemoryTypes.h"
+#include "ZorroTypes.h"
 #include "AgnusTypes.h"
 #include "DeniseTypes.h"
 #include "RTCTypes.h"
 #include "KeyboardTypes.h"
 #include "PortTypes.h"
+#include "InputRecorderTypes.h"
+#include "EventHandlerTypes.h"
 
 //
 // Enumeration types
@@ -43,7 +46,9 @@ typedef enum : long
     VA_CLX_PLF_PLF,
     VA_FILTER_ACTIVATION,
     VA_FILTER_TYPE,
+    VA_BAND_LIMITING,
     VA_BLITTER_ACCURACY,
+    VA_BLITTER_HYBRID,
     VA_FIFO_BUFFERING,
     VA_SERIAL_DEVICE
 }
@@ -75,6 +80,7 @@ typedef struct
     RTCConfig rtc;
     AudioConfig audio;
     MemoryConfig mem;
+    ZorroConfig zorro;
     AgnusConfig agnus;
     DeniseConfig denise;
     BlitterConfig blitter;
@@ -110,5 +116,19 @@ typedef struct
 }
 AmigaStats;
 
+typedef struct
+{
+    long frame;
+    long cpuInstructions;
+    long slotEvents[SLOT_COUNT];
+    long blitterWords;
+    long copperInstructions;
+    long busStalls;
+    long colorizedLines;
+    long audioSamples;
+    long hostNanos;
+}
+FrameCounters;
+
 #endif
 
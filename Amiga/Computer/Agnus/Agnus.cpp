@@ -204,9 +204,6 @@ void Agnus::_reset()
 void
 Agnus::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-
     info.bplcon0 = bplcon0;
     info.dmacon  = dmacon;
     info.diwstrt = diwstrt;
@@ -223,7 +220,7 @@ Agnus::_inspect()
     for (unsigned i = 0; i < 6; i++) info.bplpt[i] = bplpt[i];
     for (unsigned i = 0; i < 8; i++) info.sprpt[i] = sprpt[i];
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -254,13 +251,7 @@ Agnus::_dump()
 AgnusInfo
 Agnus::getInfo()
 {
-    AgnusInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 Cycle
@@ -1786,6 +1777,9 @@ Agnus::executeUntilBusIsFree()
 {
     int16_t posh = pos.h == 0 ? HPOS_MAX : pos.h - 1;
 
+    // Bring the Blitter up to date if it runs behind (hybrid mode)
+    if (hasEvent<BLT_SLOT>(BLT_COPY_HYBRID)) blitter.sync();
+
     // Check if the bus is blocked
     if (busOwner[posh] != BUS_NONE) {
 
@@ -1793,19 +1787,23 @@ Agnus::executeUntilBusIsFree()
         DMACycle delay = 0;
 
         // Execute Agnus until the bus is free
+        PROFILE_ENTER(PS_AGNUS);
         do {
 
             posh = pos.h;
             execute();
+            if (hasEvent<BLT_SLOT>(BLT_COPY_HYBRID)) blitter.sync();
             if (++delay == 2) bls = true;
 
         } while (busOwner[posh] != BUS_NONE);
+        PROFILE_LEAVE();
 
         // Clear the BLS line (Blitter slow down)
         bls = false;
 
         // Add wait states to the CPU
         cpu.addWaitStates(AS_CPU_CYCLES(DMA_CYCLES(delay)));
+        amiga.counters.busStalls += delay;
     }
 
     // Assign bus to the CPU
@@ -1905,14 +1903,21 @@ Agnus::hsyncHandler()
     assert(pos.h == 0 || pos.h == HPOS_MAX + 1);
 
     // Let Denise draw the current line
+    PROFILE_ENTER(PS_DENISE);
     denise.endOfLine(pos.v);
+    PROFILE_LEAVE();
 
     // Let Paula synthesize new sound samples
+    PROFILE_ENTER(PS_AUDIO);
     paula.audioUnit.executeUntil(clock);
+    PROFILE_LEAVE();
 
     // Let CIA B count the HSYNCs
     amiga.ciaB.incrementTOD();
 
+    // Forward the input events that have been captured by the input recorder
+    amiga.inputRecorder.hsyncHandler();
+
     // Reset the horizontal counter
     pos.h = 0;
 
@@ -2061,6 +2066,7 @@ Agnus::vsyncHandler()
     diskController.vsyncHandler();
     joystick1.execute();
     joystick2.execute();
+    amiga.automator.vsyncHandler();
 
     // Update statistics
     amiga.updateStats();
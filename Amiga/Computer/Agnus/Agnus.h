@@ -64,8 +64,16 @@ class Agnus : public AmigaComponent {
 
     // Information shown in the GUI inspector panel
     AgnusInfo info;
+
+    // The most recently published version of 'info'
+    InfoBuffer<AgnusInfo> infoBuffer;
+
+    // Information shown in the GUI event panel
     EventInfo eventInfo;
 
+    // The most recently published version of 'eventInfo'
+    InfoBuffer<EventInfo> eventInfoBuffer;
+
     // Statistics shown in the GUI monitor panel
     AgnusStats stats;
 
@@ -210,6 +210,7 @@ CopperInfo;
 typedef struct
 {
     int accuracy;
+    bool hybrid;
 }
 BlitterConfig;
 
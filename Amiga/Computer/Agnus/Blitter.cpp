@@ -62,9 +62,6 @@ Blitter::_reset()
 void
 Blitter::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     info.active  = agnus.isPending<BLT_SLOT>();
     info.bltcon0 = bltcon0;
     info.bltcon1 = bltcon1;
@@ -86,14 +83,15 @@ Blitter::_inspect()
     info.dhold = dhold;
     info.bbusy = bbusy;
     info.bzero = bzero;
-    
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void
 Blitter::_dump()
 {
     plainmsg("  Accuracy: %d\n", config.accuracy);
+    plainmsg("    Hybrid: %s\n", config.hybrid ? "yes" : "no");
     plainmsg("\n");
     plainmsg("   bltcon0: %X\n", bltcon0);
     plainmsg("\n");
@@ -138,13 +136,7 @@ Blitter::_dump()
 BlitterInfo
 Blitter::getInfo()
 {
-    BlitterInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
@@ -451,6 +443,19 @@ Blitter::serviceEvent(EventID id)
             (this->*lineBlitInstr[bltpc])();
             break;
 
+        case BLT_COPY_HYBRID:
+
+            // Emulate all lagging cycles
+            catchUp(agnus.clock);
+
+            // Emulate the current cycle
+            debug(BLT_DEBUG, "Instruction %d:%d\n", bltconUSE(), bltpc);
+            (this->*copyBlitInstr[bltconUSE()][0][bltconFE()][bltpc])();
+
+            // Let the Blitter fall behind again if the blit continues
+            if (agnus.hasEvent<BLT_SLOT>(BLT_COPY_HYBRID)) scheduleHybridEvent();
+            break;
+
         default:
             
             assert(false);
@@ -764,6 +769,36 @@ Blitter::doFill(uint16_t &data, bool &carry)
     data = HI_LO(resultHi, resultLo);
 }
 
+void
+Blitter::doFillQuick(uint16_t &data, bool &carry)
+{
+    assert(carry == 0 || carry == 1);
+
+#ifndef NDEBUG
+    uint16_t refData = data;
+    bool refCarry = carry;
+    doFill(refData, refCarry);
+#endif
+
+    /* The fill circuit moves from right to left and toggles the carry bit
+     * whenever it encounters a set bit. Hence, the carry bit seen at position
+     * i equals the initial carry XORed with the parity of all bits to the
+     * right of i. We compute all 16 carry bits at once via a prefix XOR.
+     */
+    uint16_t parity = data;
+    parity ^= parity << 1;
+    parity ^= parity << 2;
+    parity ^= parity << 4;
+    parity ^= parity << 8;
+
+    uint16_t carries = (uint16_t)(parity << 1) ^ (carry ? 0xFFFF : 0);
+
+    data = bltconEFE() ? (data ^ carries) : (data | carries);
+    carry ^= parity >> 15;
+
+    assert(data == refData && carry == refCarry);
+}
+
 void
 Blitter::prepareBlit()
 {
@@ -789,6 +824,7 @@ Blitter::startBlit()
     if (bltconLINE()) {
 
         linecount++;
+        amiga.counters.blitterWords += bltsizeH;
         plaindebug(BLT_CHECKSUM, "BLITTER Line %d (%d,%d) (%d%d%d%d) (%d %d %d %d) %x %x %x %x\n",
                    linecount, bltsizeW, bltsizeH,
                    bltconUSEA(), bltconUSEB(), bltconUSEC(), bltconUSED(),
@@ -800,6 +836,7 @@ Blitter::startBlit()
     } else {
 
         copycount++;
+        amiga.counters.blitterWords += bltsizeW * bltsizeH;
         // if (bltsizeW != 1 || bltsizeH != 4)
         {
             plaindebug(BLT_CHECKSUM, "BLITTER Blit %d (%d,%d) (%d%d%d%d) (%d %d %d %d) %x %x %x %x %s%s\n",
@@ -22,6 +22,14 @@
  *          Uses up bus cycles like the real Blitter does.
  *
  * Level 0 and 1 invoke the FastBlitter. Level 2 invokes the SlowBlitter.
+ *
+ * In level 2, copy blits can be run in hybrid mode. In this mode, the Blitter
+ * is allowed to fall behind Agnus as long as no other component can observe
+ * the difference. The lagging cycles are emulated in a single chunk when the
+ * next event that interacts with the bus is due, when the Blitter is about to
+ * signal the end of the blit, or when the CPU accesses the bus. The results
+ * are meant to be identical to those of the SlowBlitter. Hybrid mode is
+ * experimental and disabled by default.
  */
 
 class Blitter : public AmigaComponent {
@@ -32,6 +40,9 @@ class Blitter : public AmigaComponent {
     // Information shown in the GUI inspector panel
     BlitterInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<BlitterInfo> infoBuffer;
+
     // The fill pattern lookup tables
     uint8_t fillPattern[2][2][256];     // [inclusive/exclusive][carry in][data]
     uint8_t nextCarryIn[2][256];        // [carry in][data]
@@ -122,6 +133,11 @@ class Blitter : public AmigaComponent {
 
     bool lockD;
 
+    /* The first DMA cycle that hasn't been emulated yet (hybrid mode only).
+     * If this value is smaller than the Agnus clock, the Blitter lags behind.
+     */
+    Cycle syncClock;
+
 
     //
     // Flags
@@ -178,7 +194,8 @@ public:
     {
         worker
 
-        & config.accuracy;
+        & config.accuracy
+        & config.hybrid;
     }
 
     template <class T>
@@ -237,6 +254,7 @@ public:
         & fillCarry
         & mask
         & lockD
+        & syncClock
 
         & running
         & bbusy
@@ -262,6 +280,10 @@ public:
     int getAccuracy() { return config.accuracy; }
     void setAccuracy(int level) { config.accuracy = level; }
 
+    // Enables or disables hybrid execution of level 2 copy blits
+    bool getHybrid() { return config.hybrid; }
+    void setHybrid(bool value) { config.hybrid = value; }
+
 
     //
     // Methods from HardwareComponent
@@ -402,6 +424,7 @@ public:
 
     // Emulates the fill logic circuit
     void doFill(uint16_t &data, bool &carry);
+    void doFillQuick(uint16_t &data, bool &carry);
 
     // Clears the busy flag and cancels the Blitter slot
     void kill();
@@ -475,6 +498,24 @@ private:
     // Emulate the barrel shifter
     void doBarrelShifterA();
     void doBarrelShifterB();
+
+
+    //
+    //  Executing the Slow Blitter in hybrid mode
+    //
+
+public:
+
+    // Emulates all lagging Blitter cycles up to the current DMA cycle
+    void sync();
+
+private:
+
+    // Emulates all lagging Blitter cycles up to the specified cycle
+    void catchUp(Cycle targetClock);
+
+    // Schedules the next hybrid event as late as possible
+    void scheduleHybridEvent();
 };
 
 #endif
@@ -17,9 +17,6 @@ Copper::Copper(Amiga& ref) : AmigaComponent(ref)
 void
 Copper::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     info.cdang   = cdang;
     info.active  = agnus.isPending<COP_SLOT>();
     info.coppc   = coppc; // coppcBase;
@@ -30,7 +27,7 @@ Copper::_inspect()
     info.length1 = cop1end - cop1lc;
     info.length2 = cop2end - cop2lc;
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -52,13 +49,7 @@ Copper::_dump()
 CopperInfo
 Copper::getInfo()
 {
-    CopperInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
@@ -660,6 +651,7 @@ Copper::serviceEvent(EventID id)
             cop1ins = agnus.copperRead(coppc);
             // coppcBase = coppc;
             advancePC();
+            amiga.counters.copperInstructions++;
 
             // Dynamically determine the end of the Copper list
             if (copList == 1) {
@@ -19,6 +19,9 @@ class Copper : public AmigaComponent
     // Information shown in the GUI inspector panel
     CopperInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<CopperInfo> infoBuffer;
+
     // The currently executed Copper list (1 or 2)
     uint8_t copList = 1;
 
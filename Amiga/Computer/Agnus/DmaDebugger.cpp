@@ -29,6 +29,11 @@ DmaDebugger::DmaDebugger(Amiga &ref) : AmigaComponent(ref)
     setColor(BUS_BLITTER,  RgbColor((uint8_t)0xFF, 0x80, 0x00));
 }
 
+DmaDebugger::~DmaDebugger()
+{
+    if (traceFile) fclose(traceFile);
+}
+
 DMADebuggerInfo
 DmaDebugger::getInfo()
 {
@@ -100,6 +105,11 @@ DmaDebugger::setColor(BusOwner owner, RgbColor color)
     debugColor[owner][1] = color.shade(0.1);
     debugColor[owner][2] = color.tint(0.1);
     debugColor[owner][3] = color.tint(0.3);
+
+    // Convert the drawing colors to GPU format
+    for (int i = 0; i < 4; i++) {
+        debugRgba[owner][i] = GpuColor(debugColor[owner][i]).rawValue;
+    }
 }
 
 void
@@ -122,9 +132,30 @@ DmaDebugger::setOpacity(double value)
     opacity = value;
 }
 
+/* Blends two pairs of RGBA pixels with 8-bit fixed-point weights
+ * The result is (fg * fgScale + bg * bgScale) / 256 with fgScale + bgScale
+ * not exceeding 256. The red and blue channels and the green and alpha
+ * channels are processed in separate passes, each channel occupying a
+ * 16-bit lane. Hence, intermediate results cannot overflow into the
+ * neighbouring channel. The alpha channel is always set to 0xFF.
+ */
+uint64_t
+DmaDebugger::blend(uint64_t fg, uint64_t bg, uint64_t fgScale, uint64_t bgScale)
+{
+    const uint64_t mask = 0x00FF00FF00FF00FF;
+
+    uint64_t rb = ((fg & mask) * fgScale + (bg & mask) * bgScale) >> 8;
+    uint64_t ga = ((fg >> 8) & mask) * fgScale + ((bg >> 8) & mask) * bgScale;
+
+    return (rb & mask) | (ga & ~mask) | 0xFF000000FF000000;
+}
+
 void
 DmaDebugger::computeOverlay()
 {
+    // Write the bus usage into the trace file if a trace is being recorded
+    if (traceFile) { recordTrace(); return; }
+
     // Only proceed if DMA debugging has been turned on
     if (!enabled) return;
 
@@ -158,40 +189,145 @@ DmaDebugger::computeOverlay()
 
     }
 
+    // Convert the weights to 8-bit fixed-point values
+    uint64_t bgScale = 256 - (uint64_t)(bgWeight * 256.0 + 0.5);
+    uint64_t fgScale = (uint64_t)(fgWeight * 256.0 + 0.5);
+
     for (int i = 0; i < HPOS_CNT; i++, ptr += 4) {
 
         BusOwner owner = owners[i];
+        uint64_t bg[2];
+
+        memcpy(bg, ptr, sizeof(bg));
 
         // Handle the easy case first: No foreground pixels
         if (!visualize[owner]) {
 
-            if (bgWeight != 0.0) {
-                ptr[0] = GpuColor(ptr[0]).shade(bgWeight).rawValue;
-                ptr[1] = GpuColor(ptr[1]).shade(bgWeight).rawValue;
-                ptr[2] = GpuColor(ptr[2]).shade(bgWeight).rawValue;
-                ptr[3] = GpuColor(ptr[3]).shade(bgWeight).rawValue;
+            if (bgScale != 256) {
+                bg[0] = blend(0, bg[0], 0, bgScale);
+                bg[1] = blend(0, bg[1], 0, bgScale);
+                memcpy(ptr, bg, sizeof(bg));
             }
             continue;
         }
 
         // Get RGBA values of foreground pixels
-        GpuColor col0 = debugColor[owner][(values[i] & 0xC000) >> 14];
-        GpuColor col1 = debugColor[owner][(values[i] & 0x0C00) >> 10];
-        GpuColor col2 = debugColor[owner][(values[i] & 0x00C0) >> 6];
-        GpuColor col3 = debugColor[owner][(values[i] & 0x000C) >> 2];
-
-        if (fgWeight != 0.0) {
-            col0 = col0.mix(GpuColor(ptr[0]), fgWeight);
-            col1 = col1.mix(GpuColor(ptr[1]), fgWeight);
-            col2 = col2.mix(GpuColor(ptr[2]), fgWeight);
-            col3 = col3.mix(GpuColor(ptr[3]), fgWeight);
+        uint32_t col[4] = {
+            debugRgba[owner][(values[i] & 0xC000) >> 14],
+            debugRgba[owner][(values[i] & 0x0C00) >> 10],
+            debugRgba[owner][(values[i] & 0x00C0) >> 6],
+            debugRgba[owner][(values[i] & 0x000C) >> 2]
+        };
+
+        if (fgScale != 0) {
+
+            uint64_t fg[2];
+            memcpy(fg, col, sizeof(fg));
+
+            fg[0] = blend(fg[0], bg[0], 256 - fgScale, fgScale);
+            fg[1] = blend(fg[1], bg[1], 256 - fgScale, fgScale);
+            memcpy(ptr, fg, sizeof(fg));
+
+        } else {
+
+            memcpy(ptr, col, sizeof(col));
         }
+    }
+}
+
+void
+DmaDebugger::recordTrace()
+{
+    assert(traceFile != NULL);
+
+    BusOwner *owners = agnus.busOwner;
+    uint16_t *values = agnus.busValue;
 
-        ptr[0] = col0.rawValue;
-        ptr[1] = col1.rawValue;
-        ptr[2] = col2.rawValue;
-        ptr[3] = col3.rawValue;
+    uint8_t record[6 + 3 * HPOS_CNT];
+    uint8_t *ptr = record;
+
+    // Line header
+    uint32_t frame = (uint32_t)agnus.frame;
+    uint16_t vpos = (uint16_t)agnus.pos.v;
+    *ptr++ = frame & 0xFF;
+    *ptr++ = (frame >> 8) & 0xFF;
+    *ptr++ = (frame >> 16) & 0xFF;
+    *ptr++ = (frame >> 24) & 0xFF;
+    *ptr++ = LO_BYTE(vpos);
+    *ptr++ = HI_BYTE(vpos);
+
+    // Bus owners
+    for (int i = 0; i < HPOS_CNT; i++) *ptr++ = (uint8_t)owners[i];
+
+    // Bus values of all used DMA slots
+    for (int i = 0; i < HPOS_CNT; i++) {
+        if (owners[i] != BUS_NONE) {
+            *ptr++ = LO_BYTE(values[i]);
+            *ptr++ = HI_BYTE(values[i]);
+        }
+    }
+
+    size_t size = ptr - record;
+    if (fwrite(record, 1, size, traceFile) != size) {
+
+        warn("Failed to write the DMA trace. Stopping.\n");
+        fclose(traceFile);
+        traceFile = NULL;
+        return;
+    }
+
+    tracedLines++;
+}
+
+bool
+DmaDebugger::startTrace(const char *path)
+{
+    assert(path != NULL);
+
+    amiga.suspend();
+
+    stopTrace();
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        warn("Can't open %s\n", path);
+        amiga.resume();
+        return false;
     }
+
+    // Use a large buffer to keep the number of write calls low
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+
+    // Write the header
+    uint8_t header[8] = {
+        'V', 'A', 'D', 'T', 1, 0, LO_BYTE(HPOS_CNT), HI_BYTE(HPOS_CNT)
+    };
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+        warn("Failed to write %s\n", path);
+        fclose(file);
+        amiga.resume();
+        return false;
+    }
+
+    traceFile = file;
+    tracedLines = 0;
+
+    amiga.resume();
+    return true;
+}
+
+void
+DmaDebugger::stopTrace()
+{
+    if (traceFile == NULL) return;
+
+    amiga.suspend();
+
+    fclose(traceFile);
+    traceFile = NULL;
+    debug("DMA trace closed (%ld lines)\n", tracedLines);
+
+    amiga.resume();
 }
 
 void
@@ -26,6 +26,9 @@ private:
     // DMA debugging colors
     RgbColor debugColor[BUS_OWNER_COUNT][5];
 
+    // The drawing colors of debugColor in GPU format
+    uint32_t debugRgba[BUS_OWNER_COUNT][4];
+
     // Opacity of DMA pixels
     double opacity = 0.5;
 
@@ -33,6 +36,30 @@ private:
     DmaDebuggerDisplayMode displayMode = MODULATE_FG_LAYER;
 
 
+    //
+    // Bus trace
+    //
+
+    /* If a trace file is open, the bus usage of each rasterline is written
+     * to the file instead of being superimposed onto the screen. The file
+     * starts with the magic bytes "VADT", a version byte, a zero byte, and
+     * the number of DMA slots per line (16 bit). Each rasterline adds a
+     * record of the following format:
+     *
+     *     Frame number (32 bit)
+     *     Vertical position (16 bit)
+     *     Bus owner of each DMA slot (8 bit each, see BusOwner)
+     *     Bus value of each DMA slot with an owner other than BUS_NONE
+     *     (16 bit each)
+     *
+     * All multi-byte values are stored in little endian format.
+     */
+    FILE *traceFile = NULL;
+
+    // Number of rasterlines written to the trace file
+    long tracedLines = 0;
+
+
     //
     // Constructing and destructing
     //
@@ -40,6 +67,7 @@ private:
 public:
 
     DmaDebugger(Amiga &ref);
+    ~DmaDebugger();
 
 
     //
@@ -94,8 +122,35 @@ public:
     // Superimposes the debug output onto the current rasterline
     void computeOverlay();
 
+    // Blends two pairs of RGBA pixels with 8-bit fixed-point weights
+    static uint64_t blend(uint64_t fg, uint64_t bg, uint64_t fgScale, uint64_t bgScale);
+
     // Cleans up some texture data at the end of each frame
     void vSyncHandler();
+
+private:
+
+    // Writes the bus usage of the current rasterline to the trace file
+    void recordTrace();
+
+
+    //
+    // Tracing bus usage
+    //
+
+public:
+
+    // Starts writing the bus usage into a binary trace file
+    bool startTrace(const char *path);
+
+    // Closes the trace file
+    void stopTrace();
+
+    // Indicates if a trace is being recorded
+    bool isTracing() { return traceFile != NULL; }
+
+    // Returns the number of rasterlines in the current trace
+    long getTracedLines() { return tracedLines; }
 };
 
 #endif
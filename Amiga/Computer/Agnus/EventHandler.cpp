@@ -12,9 +12,6 @@
 void
 Agnus::inspectEvents()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     eventInfo.cpuClock = cpu.getMasterClock();
     eventInfo.cpuCycles = cpu.getCpuClock();
     eventInfo.dmaClock = clock;
@@ -26,8 +23,8 @@ Agnus::inspectEvents()
 
     // Inspect all slots
     for (int i = 0; i < SLOT_COUNT; i++) inspectEventSlot((EventSlot)i);
-    
-    pthread_mutex_unlock(&lock);
+
+    eventInfoBuffer.write(eventInfo);
 }
 
 void
@@ -168,13 +165,14 @@ Agnus::inspectEventSlot(EventSlot nr)
 
             switch (slot[nr].id) {
 
-                case 0:             i->eventName = "none"; break;
-                case BLT_STRT1:     i->eventName = "BLT_STRT1"; break;
-                case BLT_STRT2:     i->eventName = "BLT_STRT2"; break;
-                case BLT_COPY_SLOW: i->eventName = "BLT_COPY_SLOW"; break;
-                case BLT_COPY_FAKE: i->eventName = "BLT_COPY_FAKE"; break;
-                case BLT_LINE_FAKE: i->eventName = "BLT_LINE_FAKE"; break;
-                default:            i->eventName = "*** INVALID ***"; break;
+                case 0:               i->eventName = "none"; break;
+                case BLT_STRT1:       i->eventName = "BLT_STRT1"; break;
+                case BLT_STRT2:       i->eventName = "BLT_STRT2"; break;
+                case BLT_COPY_SLOW:   i->eventName = "BLT_COPY_SLOW"; break;
+                case BLT_COPY_FAKE:   i->eventName = "BLT_COPY_FAKE"; break;
+                case BLT_LINE_FAKE:   i->eventName = "BLT_LINE_FAKE"; break;
+                case BLT_COPY_HYBRID: i->eventName = "BLT_COPY_HYBRID"; break;
+                default:              i->eventName = "*** INVALID ***"; break;
             }
             break;
 
@@ -285,6 +283,16 @@ Agnus::inspectEventSlot(EventSlot nr)
             }
             break;
 
+        case INP_SLOT:
+
+            switch (slot[nr].id) {
+
+                case 0:             i->eventName = "none"; break;
+                case INP_INJECT:    i->eventName = "INP_INJECT"; break;
+                default:            i->eventName = "*** INVALID ***"; break;
+            }
+            break;
+
         case INS_SLOT:
 
             switch (slot[nr].id) {
@@ -335,13 +343,7 @@ Agnus::dumpEvents()
 EventInfo
 Agnus::getEventInfo()
 {
-    EventInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = eventInfo;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return eventInfoBuffer.read();
 }
 
 EventSlotInfo
@@ -349,13 +351,7 @@ Agnus::getEventSlotInfo(int nr)
 {
     assert(isEventSlot(nr));
 
-    EventSlotInfo result;
-
-    pthread_mutex_lock(&lock);
-    result = eventInfo.slotInfo[nr];
-    pthread_mutex_unlock(&lock);
-
-    return result;
+    return eventInfoBuffer.read().slotInfo[nr];
 }
 
 void
@@ -423,69 +419,112 @@ Agnus::scheduleNextREGEvent()
 void
 Agnus::executeEventsUntil(Cycle cycle) {
 
+    // Event counters for the current frame
+    long *events = amiga.counters.slotEvents;
+
     //
     // Check primary slots
     //
 
     if (isDue<REG_SLOT>(cycle)) {
+        events[REG_SLOT]++;
+        PROFILE_ENTER(PS_REG);
         serviceREGEvent(cycle);
+        PROFILE_LEAVE();
     }
     if (isDue<RAS_SLOT>(cycle)) {
+        events[RAS_SLOT]++;
+        PROFILE_ENTER(PS_RAS);
         serviceRASEvent();
+        PROFILE_LEAVE();
     }
     if (isDue<CIAA_SLOT>(cycle)) {
+        events[CIAA_SLOT]++;
+        PROFILE_ENTER(PS_CIAA);
         serviceCIAEvent<0>();
+        PROFILE_LEAVE();
     }
     if (isDue<CIAB_SLOT>(cycle)) {
+        events[CIAB_SLOT]++;
+        PROFILE_ENTER(PS_CIAB);
         serviceCIAEvent<1>();
+        PROFILE_LEAVE();
     }
     if (isDue<BPL_SLOT>(cycle)) {
+        events[BPL_SLOT]++;
+        PROFILE_ENTER(PS_BPL);
         serviceBPLEvent();
+        PROFILE_LEAVE();
     }
     if (isDue<DAS_SLOT>(cycle)) {
+        events[DAS_SLOT]++;
+        PROFILE_ENTER(PS_DAS);
         serviceDASEvent();
+        PROFILE_LEAVE();
     }
     if (isDue<COP_SLOT>(cycle)) {
+        events[COP_SLOT]++;
+        PROFILE_ENTER(PS_COP);
         copper.serviceEvent(slot[COP_SLOT].id);
+        PROFILE_LEAVE();
     }
     if (isDue<BLT_SLOT>(cycle)) {
+        events[BLT_SLOT]++;
+        PROFILE_ENTER(PS_BLT);
         blitter.serviceEvent(slot[BLT_SLOT].id);
+        PROFILE_LEAVE();
     }
 
     if (isDue<SEC_SLOT>(cycle)) {
+        events[SEC_SLOT]++;
+        PROFILE_ENTER(PS_SEC);
 
         //
         // Check secondary slots
         //
 
         if (isDue<DSK_SLOT>(cycle)) {
+            events[DSK_SLOT]++;
             paula.diskController.serviceDiskEvent();
         }
         if (isDue<DCH_SLOT>(cycle)) {
+            events[DCH_SLOT]++;
             paula.diskController.serviceDiskChangeEvent(slot[DCH_SLOT].id, (int)slot[DCH_SLOT].data);
         }
         if (isDue<VBL_SLOT>(cycle)) {
+            events[VBL_SLOT]++;
             serviceVblEvent();
         }
         if (isDue<IRQ_SLOT>(cycle)) {
+            events[IRQ_SLOT]++;
             paula.serviceIrqEvent();
         }
         if (isDue<IPL_SLOT>(cycle)) {
+            events[IPL_SLOT]++;
             paula.serviceIplEvent();
         }
         if (isDue<KBD_SLOT>(cycle)) {
+            events[KBD_SLOT]++;
             amiga.keyboard.serviceKeyboardEvent(slot[KBD_SLOT].id);
         }
         if (isDue<TXD_SLOT>(cycle)) {
+            events[TXD_SLOT]++;
             uart.serveTxdEvent(slot[TXD_SLOT].id);
         }
         if (isDue<RXD_SLOT>(cycle)) {
+            events[RXD_SLOT]++;
             uart.serveRxdEvent(slot[RXD_SLOT].id);
         }
         if (isDue<POT_SLOT>(cycle)) {
+            events[POT_SLOT]++;
             paula.servePotEvent(slot[POT_SLOT].id);
         }
+        if (isDue<INP_SLOT>(cycle)) {
+            events[INP_SLOT]++;
+            amiga.inputRecorder.serviceInputEvent();
+        }
         if (isDue<INS_SLOT>(cycle)) {
+            events[INS_SLOT]++;
             serviceINSEvent();
         }
 
@@ -497,6 +536,8 @@ Agnus::executeEventsUntil(Cycle cycle) {
 
         // Update the secondary table trigger in the primary table
         rescheduleAbs<SEC_SLOT>(nextSecTrigger);
+
+        PROFILE_LEAVE();
     }
 
     // Determine the next trigger cycle for all primary slots
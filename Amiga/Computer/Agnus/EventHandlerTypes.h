@@ -43,6 +43,7 @@ typedef enum : long
     TXD_SLOT,                       // Serial data out (UART)
     RXD_SLOT,                       // Serial data in (UART)
     POT_SLOT,                       // Potentiometer
+    INP_SLOT,                       // Recorded user input
     INS_SLOT,                       // Handles periodic calls to inspect()
     SLOT_COUNT
 
@@ -74,6 +75,7 @@ inline const char *slotName(EventSlot nr)
         case TXD_SLOT:  return "UART out";
         case RXD_SLOT:  return "UART in";
         case POT_SLOT:  return "Potentiometer";
+        case INP_SLOT:  return "Input Recorder";
         case INS_SLOT:  return "Inspector";
 
         default:
@@ -163,6 +165,7 @@ typedef enum : long
     BLT_COPY_SLOW,
     BLT_COPY_FAKE,
     BLT_LINE_FAKE,
+    BLT_COPY_HYBRID,
     BLT_EVENT_COUNT,
         
     // SEC slot
@@ -215,6 +218,11 @@ typedef enum : long
     POT_DISCHARGE = 1,
     POT_CHARGE,
     POT_EVENT_COUNT,
+
+    // Input recorder
+    INP_INJECT = 1,
+    INP_EVENT_COUNT,
+
     
     // Inspector slot
     INS_NONE = 1,
@@ -142,7 +142,7 @@ void Blitter::doFastCopyBlit()
             assert(dhold == doMintermLogic(ahold, bhold, chold, bltcon0 & 0xFF));
 
             // Run the fill logic circuit
-            if (fill) doFill(dhold, fillCarry);
+            if (fill) doFillQuick(dhold, fillCarry);
 
             // Update the zero flag
             if (dhold) bzero = false;
@@ -247,12 +247,33 @@ Blitter::doFastLineBlit()
     bool y_inc = ((!x_independent) && !(sulsudaul & 1)) || (x_independent && !(sulsudaul & 2));
     bool single_dot = false;
     uint8_t minterm = (uint8_t)(bltcon >> 16);
-    
+
+    /* Word cache for channel C and D
+     * Starting with the second pixel, channel D writes to the same word
+     * channel C has read from. As long as the line stays inside a single
+     * word, which is the case for a horizontal run of up to 16 pixels, all
+     * pixels are drawn into a cached copy of that word. The word is read once
+     * at the beginning and written back once at the end of the run. Words in
+     * unmapped Chip Ram are never cached, because writes to them are dropped
+     * and reading them back yields 0.
+     */
+    uint32_t cache_addr = 0;
+    uint16_t cache_data = 0;
+    bool cache_valid = false;
+    bool cache_dirty = false;
+
     for (i = 0; i < height; ++i)
     {
         // Read C-data from memory if the C-channel is enabled
         if (c_enabled) {
-            bltcdat_local = mem.peek16<BUS_BLITTER>(bltcpt_local);
+            if (!cache_valid || cache_addr != bltcpt_local) {
+                if (cache_dirty) mem.poke16<BUS_BLITTER>(cache_addr, cache_data);
+                cache_addr = bltcpt_local;
+                cache_data = mem.peek16<BUS_BLITTER>(cache_addr);
+                cache_valid = true;
+                cache_dirty = false;
+            }
+            bltcdat_local = cache_data;
         }
         
         // Calculate data for the A-channel
@@ -277,7 +298,13 @@ Blitter::doFastLineBlit()
         
         // Save result to D-channel, same as the C ptr after first pixel.
         if (c_enabled) { // C-channel must be enabled
-            mem.poke16<BUS_BLITTER>(bltdpt_local, bltddat_local);
+            if (bltdpt_local == cache_addr && mem.memSrc[cache_addr >> 16] != MEM_UNMAPPED) {
+                cache_data = bltddat_local;
+                cache_dirty = true;
+            } else {
+                mem.poke16<BUS_BLITTER>(bltdpt_local, bltddat_local);
+                if (bltdpt_local == cache_addr) cache_valid = false;
+            }
             check1 = fnv_1a_it32(check1, bltddat_local);
             check2 = fnv_1a_it32(check2, bltdpt_local);
         }
@@ -338,6 +365,13 @@ Blitter::doFastLineBlit()
         }
         bltdpt_local = bltcpt_local;
     }
+
+    // Write back the cached word
+    if (cache_dirty) mem.poke16<BUS_BLITTER>(cache_addr, cache_data);
+
+    // Leave the last value of channel C on the data bus
+    if (cache_valid) mem.dataBus = bltcdat_local;
+
     bltcon = bltcon & 0x0FFFFFFBF;
     if (decision_is_signed) bltcon |= 0x00000040;
     
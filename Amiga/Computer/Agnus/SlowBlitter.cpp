@@ -48,6 +48,19 @@ static const uint16_t BLTDONE   = 0b0000'0100'0000'0000;
 static const uint16_t REPEAT    = 0b0000'1000'0000'0000;
 static const uint16_t FETCH     = FETCH_A | FETCH_B | FETCH_C;
 
+/* Number of micro-instructions in the main loop of each copy blit program.
+ * The table is indexed by [bltconUSE][fill] and needs to be kept in sync with
+ * the micro-programs in initSlowBlitter(). It is used in hybrid mode to
+ * compute the earliest cycle in which the Blitter can reach the end of a blit.
+ */
+static const uint16_t loopLength[16][2] = {
+
+    { 2, 2 }, { 2, 3 }, { 2, 2 }, { 3, 3 },
+    { 3, 3 }, { 3, 4 }, { 3, 3 }, { 4, 4 },
+    { 2, 2 }, { 2, 3 }, { 2, 2 }, { 3, 3 },
+    { 3, 3 }, { 3, 4 }, { 3, 3 }, { 4, 4 }
+};
+
 void
 Blitter::initSlowBlitter()
 {
@@ -863,7 +876,12 @@ Blitter::beginSlowCopyBlit()
     lockD = true;
 
     // Schedule the first slow Blitter execution event
-    agnus.scheduleRel<BLT_SLOT>(DMA_CYCLES(1), BLT_COPY_SLOW);
+    if (config.hybrid) {
+        syncClock = agnus.clock + DMA_CYCLES(1);
+        agnus.scheduleRel<BLT_SLOT>(DMA_CYCLES(1), BLT_COPY_HYBRID);
+    } else {
+        agnus.scheduleRel<BLT_SLOT>(DMA_CYCLES(1), BLT_COPY_SLOW);
+    }
 
 #ifdef SLOW_BLT_DEBUG
 
@@ -1004,7 +1022,7 @@ Blitter::exec()
         assert(dhold == doMintermLogic(ahold, bhold, chold, bltcon0 & 0xFF));
 
         // Run the fill logic circuitry
-        if ((instr & FILL) && !lockD) doFill(dhold, fillCarry);
+        if ((instr & FILL) && !lockD) doFillQuick(dhold, fillCarry);
 
         // Update the zero flag
         if (dhold) bzero = false;
@@ -1154,3 +1172,91 @@ Blitter::doBarrelShifterB()
         bhold = (bold << (16 - bltconBSH())) | (bnew >> bltconBSH());
     }
 }
+
+void
+Blitter::sync()
+{
+    assert(agnus.hasEvent<BLT_SLOT>(BLT_COPY_HYBRID));
+
+    if (syncClock < agnus.clock) {
+
+        // Emulate all cycles up to the current cycle
+        catchUp(agnus.clock);
+
+        // Continue in sync with Agnus
+        agnus.rescheduleAbs<BLT_SLOT>(agnus.clock);
+    }
+}
+
+void
+Blitter::catchUp(Cycle targetClock)
+{
+    assert(targetClock <= agnus.clock);
+
+    // Nothing to do if the Blitter is up to date
+    if (syncClock >= targetClock) return;
+
+    debug(BLTTIM_DEBUG, "Catching up %lld cycles\n", AS_DMA_CYCLES(targetClock - syncClock));
+
+    // Remember the current beam position
+    Cycle clock = agnus.clock;
+    int16_t hpos = agnus.pos.h;
+
+    /* Rewind the beam position to the first lagging cycle. The hybrid event
+     * is always scheduled before the next HSYNC event. Hence, all lagging
+     * cycles belong to the current rasterline.
+     */
+    agnus.clock = syncClock;
+    agnus.pos.h -= AS_DMA_CYCLES(clock - syncClock);
+    assert(agnus.pos.h >= 0);
+
+    uint16_t use = bltconUSE();
+    bool fill = bltconFE();
+
+    // Execute the micro-program cycle by cycle
+    for (; agnus.clock < targetClock; agnus.clock += DMA_CYCLES(1), agnus.pos.h++) {
+
+        (this->*copyBlitInstr[use][0][fill][bltpc])();
+
+        // The end of the blit is always reached in sync with Agnus
+        assert(bbusy);
+    }
+
+    // Restore the beam position
+    agnus.clock = clock;
+    agnus.pos.h = hpos;
+
+    syncClock = targetClock;
+}
+
+void
+Blitter::scheduleHybridEvent()
+{
+    // The next cycle to emulate
+    Cycle next = agnus.clock + DMA_CYCLES(1);
+    syncClock = next;
+
+    // Compute the number of micro-instructions up to the final REPEAT
+    long length = loopLength[bltconUSE()][bltconFE()];
+    long iterations = (xCounter - 1) + (yCounter - 1) * bltsizeW;
+    long instructions = (length - bltpc) + iterations * length;
+
+    /* Determine the earliest cycle in which the end of the blit is signaled.
+     * Because each micro-instruction takes at least one cycle, this is the
+     * case when the Blitter never waits for the bus.
+     */
+    Cycle trigger = bbusy ? next + DMA_CYCLES(instructions - 1) : next;
+
+    /* Catch up before any other component can interfere with the Blitter.
+     * The CIA slots are ignored, because the CIAs neither use the bus nor
+     * access any Blitter register.
+     */
+    trigger = MIN(trigger, agnus.slot[REG_SLOT].triggerCycle - DMA_CYCLES(1));
+    trigger = MIN(trigger, agnus.slot[RAS_SLOT].triggerCycle - DMA_CYCLES(1));
+    trigger = MIN(trigger, agnus.slot[BPL_SLOT].triggerCycle - DMA_CYCLES(1));
+    trigger = MIN(trigger, agnus.slot[DAS_SLOT].triggerCycle - DMA_CYCLES(1));
+    trigger = MIN(trigger, agnus.slot[COP_SLOT].triggerCycle - DMA_CYCLES(1));
+    trigger = MIN(trigger, agnus.slot[SEC_SLOT].triggerCycle - DMA_CYCLES(1));
+
+    agnus.rescheduleAbs<BLT_SLOT>(MAX(trigger, next));
+}
@@ -0,0 +1,507 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+Automator::Automator(Amiga& ref) : AmigaComponent(ref)
+{
+    setDescription("Automator");
+}
+
+void
+Automator::_dump()
+{
+    plainmsg("        Active: %s\n", active ? "yes" : "no");
+    plainmsg("      Commands: %zu\n", script.size());
+    plainmsg("     Next line: %d\n", pc < script.size() ? script[pc].line : 0);
+    plainmsg("         Delay: %ld\n", delay);
+    plainmsg("       Blocked: %s\n", blocker ? "yes" : "no");
+    plainmsg("  Pending keys: %zu\n", keyActions.size() - keyPos);
+}
+
+// Parses up to 'max' numbers and returns the number of parsed values
+static int
+parseNumbers(const char *str, int64_t *values, int max)
+{
+    int count = 0;
+
+    while (count < max) {
+
+        while (isspace(*str)) str++;
+        if (*str == 0) break;
+
+        char *end;
+        values[count++] = (int64_t)strtoull(str, &end, 0);
+        if (end == str || (*end && !isspace(*end))) return -1;
+        str = end;
+    }
+
+    // Reject trailing garbage
+    while (isspace(*str)) str++;
+    return *str ? -1 : count;
+}
+
+bool
+Automator::parseScript(const char *text)
+{
+    vector<Command> result;
+    int line = 0;
+
+    while (*text) {
+
+        // Extract the next line
+        const char *eol = strchr(text, '\n');
+        size_t len = eol ? eol - text : strlen(text);
+        std::string str(text, len);
+        text += eol ? len + 1 : len;
+        line++;
+
+        // Remove leading and trailing white space
+        size_t first = str.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        str = str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+
+        // Skip comments
+        if (str[0] == '#') continue;
+
+        // Split the line into the keyword and the remaining part
+        size_t split = str.find_first_of(" \t");
+        std::string keyword = str.substr(0, split);
+        std::string rest;
+        if (split != std::string::npos) {
+            rest = str.substr(str.find_first_not_of(" \t", split));
+        }
+
+        Command cmd = { CMD_QUIT, line, { 0, 0, 0, 0, 0, 0 }, "" };
+        int count = 0;
+        int min = 0, max = 0;
+
+        if (keyword == "wait")            { cmd.type = CMD_WAIT; min = max = 1; }
+        else if (keyword == "waitframe")  { cmd.type = CMD_WAITFRAME; min = max = 1; }
+        else if (keyword == "waithash")   { cmd.type = CMD_WAITHASH; min = 5; max = 6; }
+        else if (keyword == "press")      { cmd.type = CMD_PRESS; min = max = 1; }
+        else if (keyword == "release")    { cmd.type = CMD_RELEASE; min = max = 1; }
+        else if (keyword == "eject")      { cmd.type = CMD_EJECT; min = max = 1; }
+        else if (keyword == "hash")       { cmd.type = CMD_HASH; min = max = 4; }
+        else if (keyword == "quit")       { cmd.type = CMD_QUIT; }
+        else if (keyword == "type")       { cmd.type = CMD_TYPE; }
+        else if (keyword == "insert")     { cmd.type = CMD_INSERT; }
+        else if (keyword == "screenshot") { cmd.type = CMD_SCREENSHOT; }
+        else {
+            warn("Line %d: Unknown command '%s'\n", line, keyword.c_str());
+            return false;
+        }
+
+        switch (cmd.type) {
+
+            case CMD_TYPE:
+
+                // Translate escape sequences
+                for (size_t i = 0; i < rest.size(); i++) {
+
+                    if (rest[i] == '\\' && i + 1 < rest.size()) {
+                        switch (rest[++i]) {
+                            case 'n': cmd.text += '\n'; break;
+                            case 't': cmd.text += '\t'; break;
+                            default:  cmd.text += rest[i]; break;
+                        }
+                    } else {
+                        cmd.text += rest[i];
+                    }
+                }
+                break;
+
+            case CMD_INSERT:
+
+                // Parse the drive number and the path
+                split = rest.find_first_of(" \t");
+                if (split == std::string::npos) {
+                    warn("Line %d: Usage: insert <drive> <path>\n", line);
+                    return false;
+                }
+                cmd.text = rest.substr(rest.find_first_not_of(" \t", split));
+                rest = rest.substr(0, split);
+                min = max = 1;
+                break;
+
+            case CMD_SCREENSHOT:
+
+                if (rest.empty()) {
+                    warn("Line %d: Usage: screenshot <path>\n", line);
+                    return false;
+                }
+                cmd.text = rest;
+                break;
+
+            default:
+                break;
+        }
+
+        // Parse the numerical arguments
+        if (max) {
+            count = parseNumbers(rest.c_str(), cmd.arg, max);
+            if (count < min) {
+                warn("Line %d: Invalid arguments for '%s'\n", line, keyword.c_str());
+                return false;
+            }
+        } else if (!rest.empty() && cmd.type == CMD_QUIT) {
+            warn("Line %d: Invalid arguments for '%s'\n", line, keyword.c_str());
+            return false;
+        }
+
+        // Check the arguments
+        bool valid = true;
+
+        switch (cmd.type) {
+
+            case CMD_WAIT:
+            case CMD_WAITFRAME:
+                valid = cmd.arg[0] >= 0;
+                break;
+
+            case CMD_WAITHASH:
+            case CMD_HASH:
+                valid =
+                cmd.arg[0] >= 0 && cmd.arg[2] >= 0 && cmd.arg[0] + cmd.arg[2] <= HPIXELS &&
+                cmd.arg[1] >= 0 && cmd.arg[3] >= 0 && cmd.arg[1] + cmd.arg[3] <= VPIXELS &&
+                cmd.arg[5] >= 0;
+                break;
+
+            case CMD_PRESS:
+            case CMD_RELEASE:
+                valid = cmd.arg[0] >= 0 && cmd.arg[0] < 0x80;
+                break;
+
+            case CMD_INSERT:
+            case CMD_EJECT:
+                valid = cmd.arg[0] >= 0 && cmd.arg[0] <= 3;
+                break;
+
+            default:
+                break;
+        }
+
+        if (!valid) {
+            warn("Line %d: Argument out of range\n", line);
+            return false;
+        }
+
+        result.push_back(cmd);
+    }
+
+    amiga.suspend();
+    if (active) terminate();
+    script = result;
+    pc = 0;
+    amiga.resume();
+
+    return true;
+}
+
+bool
+Automator::loadScript(const char *path)
+{
+    vector<char> text;
+    char chunk[4096];
+    size_t count;
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        warn("Can't open %s\n", path);
+        return false;
+    }
+
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.insert(text.end(), chunk, chunk + count);
+    }
+    text.push_back(0);
+    fclose(file);
+
+    return parseScript(text.data());
+}
+
+void
+Automator::start()
+{
+    amiga.suspend();
+
+    if (active) terminate();
+
+    pc = 0;
+    delay = 0;
+    blocker = NULL;
+    keyActions.clear();
+    keyPos = 0;
+
+    // Run at full speed
+    oldWarp = amiga.getWarp();
+    amiga.warpOn();
+
+    // Speed up hashing screen regions
+    oldLineHashing = pixelEngine.getLineHashing();
+    pixelEngine.setLineHashing(true);
+
+    active = true;
+
+    amiga.resume();
+}
+
+void
+Automator::stop()
+{
+    amiga.suspend();
+    if (active) terminate();
+    amiga.resume();
+}
+
+void
+Automator::execute()
+{
+    // Perform pending keyboard actions (one per frame)
+    if (keyPos < keyActions.size()) {
+
+        KeyAction &action = keyActions[keyPos++];
+        if (action.press) {
+            keyboard.pressKey(action.keycode);
+        } else {
+            keyboard.releaseKey(action.keycode);
+        }
+        return;
+    }
+
+    // Wait until the delay has expired
+    if (delay > 0) { delay--; return; }
+
+    // Wait until the blocking condition is met
+    if (blocker) {
+
+        if (!conditionMet(*blocker)) {
+
+            if (deadline && agnus.frame >= deadline) {
+                warn("Line %d: Timeout\n", blocker->line);
+                finish(false, blocker->line);
+            }
+            return;
+        }
+        blocker = NULL;
+    }
+
+    // Execute commands until one of them blocks
+    while (active && pc < script.size()) {
+        if (!exec(script[pc++])) return;
+    }
+
+    if (active) finish(true);
+}
+
+bool
+Automator::exec(const Command &cmd)
+{
+    switch (cmd.type) {
+
+        case CMD_WAIT:
+
+            delay = cmd.arg[0] - 1;
+            return cmd.arg[0] == 0;
+
+        case CMD_WAITFRAME:
+        case CMD_WAITHASH:
+
+            if (conditionMet(cmd)) return true;
+
+            blocker = &cmd;
+            deadline = cmd.arg[5] ? agnus.frame + cmd.arg[5] : 0;
+            return false;
+
+        case CMD_TYPE:
+
+            typeText(cmd.text);
+            return keyActions.empty();
+
+        case CMD_PRESS:
+
+            keyboard.pressKey(cmd.arg[0]);
+            return true;
+
+        case CMD_RELEASE:
+
+            keyboard.releaseKey(cmd.arg[0]);
+            return true;
+
+        case CMD_INSERT:
+
+            if (ADFFile *adf = ADFFile::makeWithFile(cmd.text.c_str())) {
+
+                diskController.insertDisk(adf, (int)cmd.arg[0]);
+                delete adf;
+                return true;
+            }
+            warn("Line %d: Can't load %s\n", cmd.line, cmd.text.c_str());
+            finish(false, cmd.line);
+            return false;
+
+        case CMD_EJECT:
+
+            diskController.ejectDisk((int)cmd.arg[0]);
+            return true;
+
+        case CMD_SCREENSHOT:
+
+            if (saveScreenshot(cmd.text.c_str())) return true;
+            finish(false, cmd.line);
+            return false;
+
+        case CMD_HASH:
+
+            msg("Line %d: Frame %lld: Region (%lld,%lld,%lld,%lld) has hash %016llX\n",
+                cmd.line, agnus.frame, cmd.arg[0], cmd.arg[1], cmd.arg[2], cmd.arg[3],
+                pixelEngine.hashRegion((int)cmd.arg[0], (int)cmd.arg[1],
+                                       (int)cmd.arg[2], (int)cmd.arg[3]));
+            return true;
+
+        case CMD_QUIT:
+
+            finish(true);
+            return false;
+    }
+
+    return true;
+}
+
+bool
+Automator::conditionMet(const Command &cmd)
+{
+    switch (cmd.type) {
+
+        case CMD_WAITFRAME:
+
+            return agnus.frame >= cmd.arg[0];
+
+        case CMD_WAITHASH:
+
+            return pixelEngine.hashRegion((int)cmd.arg[0], (int)cmd.arg[1],
+                                          (int)cmd.arg[2], (int)cmd.arg[3])
+            == (uint64_t)cmd.arg[4];
+
+        default:
+
+            return true;
+    }
+}
+
+void
+Automator::finish(bool success, int line)
+{
+    terminate();
+
+    if (success) {
+        msg("Script completed in frame %lld\n", agnus.frame);
+    } else {
+        msg("Script aborted in line %d\n", line);
+    }
+
+    amiga.putMessage(success ? MSG_SCRIPT_DONE : MSG_SCRIPT_ABORT, line);
+    amiga.signalStop();
+}
+
+void
+Automator::terminate()
+{
+    active = false;
+    delay = 0;
+    blocker = NULL;
+    keyActions.clear();
+    keyPos = 0;
+
+    if (!oldWarp) amiga.warpOff();
+    pixelEngine.setLineHashing(oldLineHashing);
+}
+
+void
+Automator::typeText(const std::string &text)
+{
+    // Amiga keycodes of the US keyboard layout (starting at keycode 0x00,
+    // 0x10, 0x20, and 0x31, respectively)
+    static const char *rows[2][4] = {
+        { "`1234567890-=\\", "qwertyuiop[]", "asdfghjkl;'", "zxcvbnm,./" },
+        { "~!@#$%^&*()_+|",  "QWERTYUIOP{}", "ASDFGHJKL:\"", "ZXCVBNM<>?" }
+    };
+    static const long base[4] = { 0x00, 0x10, 0x20, 0x31 };
+    static const long shiftKey = 0x60;
+
+    keyActions.clear();
+    keyPos = 0;
+
+    for (char c : text) {
+
+        long keycode = -1;
+        bool shift = false;
+
+        switch (c) {
+
+            case ' ':  keycode = 0x40; break;
+            case '\t': keycode = 0x42; break;
+            case '\n': keycode = 0x44; break;
+
+            default:
+
+                for (int s = 0; s < 2 && keycode < 0; s++) {
+                    for (int r = 0; r < 4 && keycode < 0; r++) {
+                        if (const char *pos = strchr(rows[s][r], c)) {
+                            keycode = base[r] + (pos - rows[s][r]);
+                            shift = s;
+                        }
+                    }
+                }
+        }
+
+        if (keycode < 0) {
+            warn("Can't type character %d\n", c);
+            continue;
+        }
+
+        if (shift) keyActions.push_back(KeyAction { shiftKey, true });
+        keyActions.push_back(KeyAction { keycode, true });
+        keyActions.push_back(KeyAction { keycode, false });
+        if (shift) keyActions.push_back(KeyAction { shiftKey, false });
+    }
+}
+
+bool
+Automator::saveScreenshot(const char *path)
+{
+    ScreenBuffer buffer = pixelEngine.getStableLongFrame();
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        warn("Can't open %s\n", path);
+        return false;
+    }
+
+    // Write the image as a binary PPM file
+    fprintf(file, "P6\n%d %d\n255\n", HPIXELS, VPIXELS);
+
+    uint8_t line[3 * HPIXELS];
+    for (int y = 0; y < VPIXELS; y++) {
+
+        int32_t *pixel = buffer.data + y * HPIXELS;
+        for (int x = 0; x < HPIXELS; x++) {
+            line[3 * x + 0] = pixel[x] & 0xFF;
+            line[3 * x + 1] = (pixel[x] >> 8) & 0xFF;
+            line[3 * x + 2] = (pixel[x] >> 16) & 0xFF;
+        }
+        fwrite(line, 1, sizeof(line), file);
+    }
+
+    bool success = !ferror(file);
+    fclose(file);
+
+    if (!success) warn("Failed to write %s\n", path);
+    return success;
+}
@@ -0,0 +1,182 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _AUTOMATOR_INC
+#define _AUTOMATOR_INC
+
+#include "AmigaComponent.h"
+
+#include <string>
+
+/* Script interpreter for running the emulator without a GUI
+ *
+ * The automator executes simple scripts which insert disks, type text, and
+ * wait for certain screen contents. It is intended for automated test runs.
+ * A script consists of one command per line. Empty lines and lines starting
+ * with '#' are ignored. The following commands are supported:
+ *
+ *     wait <frames>                     Waits for the specified number of frames
+ *     waitframe <frame>                 Waits until the frame counter reaches a value
+ *     waithash <x> <y> <w> <h> <hash> [<timeout>]
+ *                                       Waits until a screen region has a certain hash
+ *     type <text>                       Types some text (\n = Return, \t = Tab)
+ *     press <keycode>                   Presses a key
+ *     release <keycode>                 Releases a key
+ *     insert <drive> <path>             Inserts an ADF into df<drive>
+ *     eject <drive>                     Ejects the disk from df<drive>
+ *     screenshot <path>                 Saves the stable long frame as a PPM image
+ *     hash <x> <y> <w> <h>              Prints the hash value of a screen region
+ *     quit                              Terminates the script
+ *
+ * The script is executed by the emulator thread at the beginning of each
+ * frame. Hence, all commands are executed at well-defined points in time.
+ * While the script is running, warp mode is enabled to execute the test at
+ * full host speed. When the script terminates, the emulator is paused.
+ * Hashes are computed by PixelEngine::hashRegion(). Line hashing is enabled
+ * while a script is running which speeds up checking full-width regions.
+ */
+class Automator : public AmigaComponent {
+
+    // Script commands
+    typedef enum
+    {
+        CMD_WAIT,
+        CMD_WAITFRAME,
+        CMD_WAITHASH,
+        CMD_TYPE,
+        CMD_PRESS,
+        CMD_RELEASE,
+        CMD_INSERT,
+        CMD_EJECT,
+        CMD_SCREENSHOT,
+        CMD_HASH,
+        CMD_QUIT
+    }
+    CommandType;
+
+    // A parsed script line
+    struct Command {
+
+        CommandType type;
+        int line;
+        int64_t arg[6];
+        std::string text;
+    };
+
+    // A pending keyboard action
+    struct KeyAction {
+
+        long keycode;
+        bool press;
+    };
+
+    // The parsed script
+    vector<Command> script;
+
+    // Index of the next command to execute
+    size_t pc = 0;
+
+    // Indicates if a script is being executed
+    bool active = false;
+
+    // Indicates if the emulator has been in warp mode when the script started
+    bool oldWarp = false;
+
+    // Indicates if line hashing has been enabled when the script started
+    bool oldLineHashing = false;
+
+    // Number of frames to wait before executing the next command
+    long delay = 0;
+
+    // The command that blocks the script until a condition is met
+    const Command *blocker = NULL;
+
+    // Frame at which the blocking command times out
+    Frame deadline = 0;
+
+    // Keyboard actions that are executed one per frame
+    vector<KeyAction> keyActions;
+    size_t keyPos = 0;
+
+
+    //
+    // Constructing and destructing
+    //
+
+public:
+
+    Automator(Amiga& ref);
+
+
+    //
+    // Methods from HardwareComponent
+    //
+
+private:
+
+    void _reset() override { }
+    void _dump() override;
+    size_t _size() override { return 0; }
+    size_t _load(uint8_t *buffer) override { return 0; }
+    size_t _save(uint8_t *buffer) override { return 0; }
+
+
+    //
+    // Loading scripts
+    //
+
+public:
+
+    // Parses a script (returns false on syntax errors)
+    bool parseScript(const char *text);
+
+    // Reads and parses a script file
+    bool loadScript(const char *path);
+
+
+    //
+    // Running scripts
+    //
+
+    // Starts executing the current script
+    void start();
+
+    // Stops executing the current script
+    void stop();
+
+    // Indicates if a script is being executed
+    bool isActive() { return active; }
+
+    // Executes the script (called by Agnus at the beginning of each frame)
+    void vsyncHandler() { if (active) execute(); }
+
+private:
+
+    void execute();
+
+    // Executes a single command (returns false if the command blocks)
+    bool exec(const Command &cmd);
+
+    // Checks if the condition of a blocking command is met
+    bool conditionMet(const Command &cmd);
+
+    // Terminates the script, informs the GUI, and pauses the emulator
+    void finish(bool success, int line = 0);
+
+    // Resets the execution state and restores the warp and hashing mode
+    void terminate();
+
+    // Translates a string into a sequence of keyboard actions
+    void typeText(const std::string &text);
+
+    // Writes the stable long frame into a PPM file
+    bool saveScreenshot(const char *path);
+};
+
+#endif
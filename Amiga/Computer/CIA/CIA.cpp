@@ -59,9 +59,6 @@ CIA::_reset()
 void
 CIA::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-
     updatePA();
     info.portA.port = PA;
     info.portA.reg = PRA;
@@ -97,8 +94,8 @@ CIA::_inspect()
     
     info.idleCycles = idle();
     info.idlePercentage = clock ? (double)idleCycles / (double)clock : 100.0;
-    
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void
@@ -109,6 +106,8 @@ CIA::emulateRisingEdgeOnFlagPin()
 void
 CIA::emulateFallingEdgeOnFlagPin()
 {
+    wakeUp();
+
     icr |= 0x10; // Note: FLAG pin is inverted
     
     if (imr & 0x10) {
@@ -308,19 +307,19 @@ CIA::spypeek(uint16_t addr)
             
         case 0x04: // CIA_TIMER_A_LOW
             running = delay & CIACountA3;
-            return LO_BYTE(counterA - (running ? (uint16_t)idle() : 0));
+            return LO_BYTE(spyCounter(counterA, latchA, running));
             
         case 0x05: // CIA_TIMER_A_HIGH
             running = delay & CIACountA3;
-            return HI_BYTE(counterA - (running ? (uint16_t)idle() : 0));
+            return HI_BYTE(spyCounter(counterA, latchA, running));
             
         case 0x06: // CIA_TIMER_B_LOW
             running = delay & CIACountB3;
-            return LO_BYTE(counterB - (running ? (uint16_t)idle() : 0));
+            return LO_BYTE(spyCounter(counterB, latchB, running));
             
         case 0x07: // CIA_TIMER_B_HIGH
             running = delay & CIACountB3;
-            return HI_BYTE(counterB - (running ? (uint16_t)idle() : 0));
+            return HI_BYTE(spyCounter(counterB, latchB, running));
             
         case 0x08: // CIA_EVENT_0_7
             return tod.getCounterLo();
@@ -352,6 +351,19 @@ CIA::spypeek(uint16_t addr)
     }
 }
 
+uint16_t
+CIA::spyCounter(uint16_t counter, uint16_t latch, bool running)
+{
+    CIACycle elapsed = running ? AS_CIA_CYCLES(idle()) : 0;
+
+    // Check if the timer has underflowed while the CIA was sleeping
+    if (elapsed < counter) return counter - elapsed;
+
+    // After an underflow, the timer pauses for one cycle
+    CIACycle phase = (elapsed - counter) % (latch + 1);
+    return phase ? latch + 1 - phase : latch;
+}
+
 void
 CIA::poke(uint16_t addr, uint8_t value)
 {
@@ -727,25 +739,94 @@ CIA::_dump()
 CIAInfo
 CIA::getInfo()
 {
-    CIAInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
 CIA::executeOneCycle()
+{
+    uint64_t oldDelay = delay;
+    uint64_t oldFeed  = feed;
+
+    emulateCycle();
+
+    // Go into idle state if possible
+    if (oldDelay == delay && oldFeed == feed) tiredness++; else tiredness = 0;
+  
+    // Sleep if threshold is reached
+    if (tiredness > 8) {
+        sleep();
+        scheduleWakeUp();
+    } else {
+        scheduleNextExecution();
+    }
+}
+
+void
+CIA::executeCycles(CIACycle count)
+{
+    while (count > 0) {
+
+        // Fast forward if nothing happens apart from counting down the timers
+        CIACycle bulk = MIN(count, quietCycles());
+
+        if (bulk > 0) {
+
+            if (delay & CIACountA3) counterA -= bulk;
+            if (delay & CIACountB3) counterB -= bulk;
+            clock += CIA_CYCLES(bulk);
+            count -= bulk;
+
+        } else {
+
+            emulateCycle();
+            count--;
+        }
+    }
+}
+
+CIACycle
+CIA::quietCycles()
+{
+    // The pipeline must be in a steady state
+    if ((((delay << 1) & CIADelayMask) | feed) != delay) return 0;
+
+    // The timers must not underflow
+    CIACycle result = INT64_MAX;
+    if (delay & CIACountA3) result = MIN(result, (CIACycle)counterA - 1);
+    if (delay & CIACountB3) result = MIN(result, (CIACycle)counterB - 1);
+
+    return MAX(result, 0);
+}
+
+bool
+CIA::timerAIsSilent()
+{
+    return
+    (feed & CIACountA0) &&          // Timer counts system cycles
+    !(feed & CIAOneShotA0) &&       // Timer runs in continuous mode
+    !(imr & 0x01) &&                // Underflows don't trigger interrupts
+    !(CRA & 0x42) &&                // Underflows don't drive PB6 or SP
+    (CRB & 0x41) != 0x41;           // Timer B doesn't count underflows
+}
+
+bool
+CIA::timerBIsSilent()
+{
+    return
+    (feed & CIACountB0) &&          // Timer counts system cycles
+    !(feed & CIAOneShotB0) &&       // Timer runs in continuous mode
+    !(imr & 0x02) &&                // Underflows don't trigger interrupts
+    !(CRB & 0x02);                  // Underflows don't drive PB7
+}
+
+void
+CIA::emulateCycle()
 {
     clock += CIA_CYCLES(1);
     
     // debug("Executing CIA: new clock = %lld\n", clock);
     
-    uint64_t oldDelay = delay;
-    uint64_t oldFeed  = feed;
-    
     //
 	// Layout of timer (A and B)
 	//
@@ -1042,17 +1123,6 @@ CIA::executeOneCycle()
 
 	// Move delay flags left and feed in new bits
 	delay = ((delay << 1) & CIADelayMask) | feed;
-    
-    // Go into idle state if possible
-    if (oldDelay == delay && oldFeed == feed) tiredness++; else tiredness = 0;
-  
-    // Sleep if threshold is reached
-    if (tiredness > 8) {
-        sleep();
-        scheduleWakeUp();
-    } else {
-        scheduleNextExecution();
-    }
 }
 
 void
@@ -1089,6 +1159,10 @@ CIA::sleep()
     // CIAs with stopped timers can sleep forever
     if (!(feed & CIACountA0)) sleepA = INT64_MAX;
     if (!(feed & CIACountB0)) sleepB = INT64_MAX;
+
+    // Underflows without any visible effect are emulated in wakeUp()
+    if (timerAIsSilent()) sleepA = INT64_MAX;
+    if (timerBIsSilent()) sleepB = INT64_MAX;
     
     // ZZzzzz
     // debug("ZZzzzz: clock = %lld A = %d B = %d sleepA = %lld sleepB = %lld\n", clock, counterA, counterB, sleepA, sleepB);
@@ -1121,19 +1195,10 @@ CIA::wakeUp(Cycle targetCycle)
     // Make up for missed cycles
     if (missedCycles > 0) {
         
-        if (feed & CIACountA0) {
-            assert(counterA >= AS_CIA_CYCLES(missedCycles));
-            counterA -= AS_CIA_CYCLES(missedCycles);
-            // debug("Making up %d timer A cycles\n", AS_CIA_CYCLES(missedCycles));
-        }
-        if (feed & CIACountB0) {
-            assert(counterB >= AS_CIA_CYCLES(missedCycles));
-            counterB -= AS_CIA_CYCLES(missedCycles);
-            // debug("Making up %d timer B cycles\n", AS_CIA_CYCLES(missedCycles));
-        }
-        
+        executeCycles(AS_CIA_CYCLES(missedCycles));
+        assert(clock == targetCycle);
+
         idleCycles += missedCycles;
-        clock = targetCycle;
     }
     
     // Schedule the next execution event
@@ -1314,14 +1379,14 @@ CIAA::setKeyCode(uint8_t keyCode)
 {
     debug(CIA_DEBUG, "setKeyCode: %X\n", keyCode);
     
+    // Wake up the CIA
+    wakeUp();
+
     // Put the key code into the serial data register
     SDR = keyCode;
     
     // Trigger a serial data interrupt
     delay |= CIASerInt0;
-
-    // Wake up the CIA
-    wakeUp();
 }
 
 // -----------------------------------------------------------------------------
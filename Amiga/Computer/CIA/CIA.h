@@ -85,6 +85,9 @@ protected:
     // The information shown in the GUI inspector panel
     CIAInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<CIAInfo> infoBuffer;
+
 
     //
     // Sub components
@@ -463,6 +466,13 @@ public:
     // Peeks a value from a CIA register without causing side effects.
     uint8_t spypeek(uint16_t addr);
     
+private:
+    
+    // Computes the current value of a timer counter while the CIA is asleep
+    uint16_t spyCounter(uint16_t counter, uint16_t latch, bool running);
+    
+public:
+    
     // Pokes a value into a CIA register.
     void poke(uint16_t addr, uint8_t value);
     
@@ -479,6 +489,29 @@ public:
     // Executes the CIA for one CIA cycle.
     void executeOneCycle();
     
+    /* Executes the CIA for the specified number of CIA cycles.
+     * As long as the delay pipeline is in a steady state, the timers are
+     * advanced arithmetically up to the next underflow. All other cycles are
+     * emulated one by one.
+     */
+    void executeCycles(CIACycle count);
+    
+private:
+    
+    // Emulates a single CIA cycle without scheduling any events
+    void emulateCycle();
+    
+    /* Returns the number of cycles that can be skipped without missing a
+     * state change. Only the timer counters change in this period.
+     */
+    CIACycle quietCycles();
+    
+    // Checks if a timer underflow would go unnoticed outside the CIA
+    bool timerAIsSilent();
+    bool timerBIsSilent();
+    
+public:
+    
     // Schedules the next execution event
     void scheduleNextExecution();
     
@@ -26,14 +26,11 @@ TOD::_powerOn()
 void
 TOD::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     info.value = tod;
     info.latch = latch;
     info.alarm = alarm;
-    
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void 
@@ -57,13 +54,7 @@ TOD::_reset()
 CounterInfo
 TOD::getInfo()
 {
-    CounterInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
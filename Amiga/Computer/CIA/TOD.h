@@ -24,6 +24,9 @@ private:
     
     // Information shown in the GUI inspector panel
     CounterInfo info;
+
+    // The most recently published version of 'info'
+    InfoBuffer<CounterInfo> infoBuffer;
     
 private:
     
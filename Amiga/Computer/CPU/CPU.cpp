@@ -16,7 +16,9 @@ CPU::sync(int cycles)
     clock += cycles;
 
     // Emulate Agnus up to the same cycle
+    PROFILE_ENTER(PS_AGNUS);
     agnus.executeUntil(CPU_CYCLES(clock));
+    PROFILE_LEAVE();
 }
 
 moira::u8
@@ -34,6 +36,12 @@ CPU::read16(moira::u32 addr)
 moira::u16
 CPU::read16Dasm(moira::u32 addr)
 {
+    // Read from the recorded instruction words if a record is disassembled
+    if (dasmCode) {
+        moira::u32 offset = (addr - dasmBase) / 2;
+        return offset < dasmWords ? dasmCode[offset] : 0;
+    }
+
     return mem.spypeek16(addr);
 }
 
@@ -113,25 +121,65 @@ CPU::_reset()
 void
 CPU::_inspect()
 {
-    uint32_t pc;
-
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-
-    pc = getPC();
+    CPURecord rec;
 
     // Registers
-    info.pc = pc;
+    rec.pc = getPC();
 
     for (int i = 0; i < 8; i++) {
-        info.d[i] = getD(i);
-        info.a[i] = getA(i);
+        rec.d[i] = getD(i);
+        rec.a[i] = getA(i);
+    }
+    rec.usp = getUSP();
+    rec.ssp = getSSP();
+    rec.sr = getSR();
+
+    // Instruction words starting at the program counter
+    for (int i = 0; i < CPUINFO_INSTR_COUNT * maxInstrWords; i++) {
+        rec.code[i] = mem.spypeek16(rec.pc + 2 * i);
     }
-    info.usp = getUSP();
-    info.ssp = getSSP();
-    info.sr = getSR();
+
+    // Most recent entries in the trace buffer
+    rec.loggedCount = debugger.loggedInstructions();
+    for (int i = 0; i < rec.loggedCount; i++) {
+
+        moira::Registers r = debugger.logEntryAbs(i);
+        rec.loggedPC[i] = r.pc;
+        rec.loggedSR[i] = r.sr;
+        for (int j = 0; j < maxInstrWords; j++) {
+            rec.loggedCode[i][j] = mem.spypeek16(r.pc + 2 * j);
+        }
+    }
+
+    // Disassembling is left to the reader
+    record.write(rec);
+}
+
+void
+CPU::updateInfo()
+{
+    // Only proceed if something has been recorded since the last call
+    uint64_t version = record.version();
+    if (version == infoVersion) return;
+
+    CPURecord rec = record.read();
+    uint32_t pc = rec.pc;
+
+    infoVersion = version;
+
+    // Registers
+    info.pc = pc;
+    memcpy(info.d, rec.d, sizeof(info.d));
+    memcpy(info.a, rec.a, sizeof(info.a));
+    info.usp = rec.usp;
+    info.ssp = rec.ssp;
+    info.sr = rec.sr;
 
     // Disassemble the program starting at the program counter
+    dasmCode = rec.code;
+    dasmBase = rec.pc;
+    dasmWords = CPUINFO_INSTR_COUNT * maxInstrWords;
+
     for (unsigned i = 0; i < CPUINFO_INSTR_COUNT; i++) {
 
         int bytes = disassemble(pc, info.instr[i].instr);
@@ -143,16 +191,18 @@ CPU::_inspect()
     }
 
     // Disassemble the most recent entries in the trace buffer
-    long count = debugger.loggedInstructions();
-    for (int i = 0; i < count; i++) {
+    for (int i = 0; i < rec.loggedCount; i++) {
 
-        moira::Registers r = debugger.logEntryAbs(i);
-        disassemble(r.pc, info.loggedInstr[i].instr);
-        disassemblePC(r.pc, info.loggedInstr[i].addr);
-        disassembleSR(r.sr, info.loggedInstr[i].sr);
+        dasmCode = rec.loggedCode[i];
+        dasmBase = rec.loggedPC[i];
+        dasmWords = maxInstrWords;
+
+        disassemble(rec.loggedPC[i], info.loggedInstr[i].instr);
+        disassemblePC(rec.loggedPC[i], info.loggedInstr[i].addr);
+        disassembleSR(rec.loggedSR[i], info.loggedInstr[i].sr);
     }
 
-    pthread_mutex_unlock(&lock);
+    dasmCode = NULL;
 }
 
 void
@@ -164,7 +214,11 @@ void
 CPU::_dump()
 {
     _inspect();
-    
+
+    pthread_mutex_lock(&lock);
+    updateInfo();
+    pthread_mutex_unlock(&lock);
+
     plainmsg("      PC: %8X\n", info.pc);
     plainmsg(" D0 - D3: ");
     for (unsigned i = 0; i < 4; i++) plainmsg("%8X ", info.d[i]);
@@ -188,6 +242,7 @@ CPU::getInfo()
     CPUInfo result;
     
     pthread_mutex_lock(&lock);
+    updateInfo();
     result = info;
     pthread_mutex_unlock(&lock);
     
@@ -202,6 +257,7 @@ CPU::getInstrInfo(long index)
     DisassembledInstr result;
     
     pthread_mutex_lock(&lock);
+    updateInfo();
     result = info.instr[index];
     pthread_mutex_unlock(&lock);
     
@@ -216,6 +272,7 @@ CPU::getLoggedInstrInfo(long index)
     DisassembledInstr result;
     
     pthread_mutex_lock(&lock);
+    updateInfo();
     result = info.loggedInstr[index];
     pthread_mutex_unlock(&lock);
     
@@ -15,8 +15,47 @@
 
 class CPU : public AmigaComponent, public moira::Moira {
 
-    // Information shown in the GUI inspector panel
+    // Maximum size of a 68000 instruction in words
+    static const int maxInstrWords = 5;
+
+    // Raw register state as recorded by the emulator thread
+    struct CPURecord {
+
+        moira::u32 pc;
+        moira::u32 d[8];
+        moira::u32 a[8];
+        moira::u32 usp;
+        moira::u32 ssp;
+        moira::u16 sr;
+
+        // Instruction words starting at the program counter
+        moira::u16 code[CPUINFO_INSTR_COUNT * maxInstrWords];
+
+        // Program counters, status registers, and instructions from the log
+        long loggedCount;
+        moira::u32 loggedPC[CPUINFO_INSTR_COUNT];
+        moira::StatusRegister loggedSR[CPUINFO_INSTR_COUNT];
+        moira::u16 loggedCode[CPUINFO_INSTR_COUNT][maxInstrWords];
+    };
+
+    // The most recently recorded register state
+    InfoBuffer<CPURecord> record;
+
+    /* Information shown in the GUI inspector panel
+     * This variable is computed on the reader side from the recorded register
+     * state. It is guarded by 'lock' and only recomputed if a new record has
+     * been published since the last computation.
+     */
     CPUInfo info;
+    uint64_t infoVersion = UINT64_MAX;
+
+    /* Instruction words read by the disassembler
+     * While a record is disassembled, read16Dasm() is served from the copy of
+     * the instruction words stored in the record. Memory is not accessed.
+     */
+    const moira::u16 *dasmCode = NULL;
+    moira::u32 dasmBase = 0;
+    moira::u32 dasmWords = 0;
 
 public:
 
@@ -87,6 +126,13 @@ public:
     DisassembledInstr getInstrInfo(long nr);
     DisassembledInstr getLoggedInstrInfo(long nr);
 
+private:
+
+    // Disassembles the recorded state into 'info' if it is outdated
+    void updateInfo();
+
+public:
+
     //
     // Methods from Moira
     //
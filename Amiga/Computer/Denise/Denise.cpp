@@ -8,6 +8,7 @@
 // -----------------------------------------------------------------------------
 
 #include "Amiga.h"
+#include "sse_utils.h"
 
 int dirk = 0;
 
@@ -49,14 +50,38 @@ Denise::_reset()
     memset(iBuffer, 0, sizeof(iBuffer));
     memset(mBuffer, 0, sizeof(mBuffer));
     memset(zBuffer, 0, sizeof(zBuffer));
+
+    clxCount = 0;
+    clxLines[0].pairs = 0;
+
+    tableConfig = -1;
+}
+
+size_t
+Denise::didLoadFromBuffer(uint8_t *buffer)
+{
+    // Discard the collision masks recorded before the snapshot was loaded
+    clxCount = 0;
+    clxLines[0].pairs = 0;
+
+    // Force the translation tables to be recomputed
+    tableConfig = -1;
+
+    return 0;
+}
+
+size_t
+Denise::willSaveToBuffer(uint8_t *buffer)
+{
+    // Make sure that CLXDAT is up to date
+    evaluateCollisions();
+
+    return 0;
 }
 
 void
 Denise::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     // Biplane information
     info.bplcon0 = bplcon0;
     info.bplcon1 = bplcon1;
@@ -104,7 +129,7 @@ Denise::_inspect()
         // debug("%d: hstrt = %d vstsrt = %d vstop = %d\n", i, info.sprite[i].hstrt, info.sprite[i].vstrt, info.sprite[i].vstop);
     }
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -124,25 +149,13 @@ Denise::_dump()
 DeniseInfo
 Denise::getInfo()
 {
-    DeniseInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 SpriteInfo
 Denise::getSprInfo(int nr)
 {
-    SpriteInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info.sprite[nr];
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read().sprite[nr];
 }
 
 uint16_t
@@ -284,6 +297,9 @@ Denise::zPF(uint16_t priorityBits)
 uint16_t
 Denise::peekCLXDAT()
 {
+    // Compute the collision bits of all lines drawn since the last read
+    evaluateCollisions();
+
     uint16_t result = clxdat | 0x8000;
     clxdat = 0;
     return result;
@@ -541,6 +557,19 @@ Denise::draw(int pixels)
 #endif
 }
 
+// Sets all bits in the range [from; to) of a collision mask
+static void
+setBits(uint64_t *mask, int from, int to)
+{
+    for (int i = from; i < to; ) {
+
+        int bit = i & 63;
+        int n = MIN(64 - bit, to - i);
+        mask[i >> 6] |= (n == 64 ? ~0ULL : ((1ULL << n) - 1)) << bit;
+        i += n;
+    }
+}
+
 void
 Denise::translate()
 {
@@ -550,25 +579,24 @@ Denise::translate()
     bool dual = dbplf(bplcon0);
 
     uint16_t bplcon2 = initialBplcon2;
-    bool pri = PF2PRI(bplcon2);
-    prio1 = zPF1(bplcon2);
-    prio2 = zPF2(bplcon2);
+    updateTranslationTables(dual, bplcon2);
     // updateSpritePriorities(bplcon2);
 
     // Add a dummy register change to ensure we draw until the line ends
     conRegChanges.add(sizeof(bBuffer), REG_NONE, 0);
 
+    // Clear the dual-playfield mask used for collision checking
+    uint64_t *dpf = clxLines[clxCount].dpf;
+    memset(dpf, 0, sizeof(clxLines[clxCount].dpf));
+
     // Iterate over all recorded register changes
     for (int i = conRegChanges.begin(); i != conRegChanges.end(); i = conRegChanges.next(i)) {
 
         Change &change = conRegChanges.change[i];
 
         // Translate a chunk of bitplane data
-        if (dual) {
-            translateDPF(pri, pixel, change.trigger);
-        } else {
-            translateSPF(pixel, change.trigger);
-        }
+        translate(pixel, change.trigger);
+        if (dual) setBits(dpf, pixel, change.trigger);
         pixel = change.trigger;
         if (pixel < 0) {
             conRegChanges.dump();
@@ -581,13 +609,12 @@ Denise::translate()
             case REG_BPLCON0_DENISE:
                 bplcon0 = change.value;
                 dual = dbplf(bplcon0);
+                updateTranslationTables(dual, bplcon2);
                 break;
 
             case REG_BPLCON2:
                 bplcon2 = change.value;
-                pri = PF2PRI(bplcon2);
-                prio1 = zPF1(bplcon2);
-                prio2 = zPF2(bplcon2);
+                updateTranslationTables(dual, bplcon2);
                 break;
 
             default:
@@ -601,41 +628,52 @@ Denise::translate()
 }
 
 void
-Denise::translateSPF(int from, int to)
+Denise::updateTranslationTables(bool dual, uint16_t bplcon2)
 {
-    // The usual case: prio2 is a valid value
-    if (prio2) {
-        for (int i = from; i < to; i++) {
-
-            uint8_t s = bBuffer[i];
+    prio1 = zPF1(bplcon2);
+    prio2 = zPF2(bplcon2);
 
-            assert(PixelEngine::isRgbaIndex(s));
-            iBuffer[i] = mBuffer[i] = s;
-            zBuffer[i] = s ? prio2 : 0;
-        }
+    // Check if the tables are up to date (PF2PRI, PF2P2 - PF2P0, PF1P2 - PF1P0)
+    int config = (dual ? 0x80 : 0) | (bplcon2 & 0x7F);
+    if (config == tableConfig) return;
+    tableConfig = config;
 
-    // The unusual case: prio2 is ivalid
+    if (!dual) {
+        computeSPFTables();
+    } else if (PF2PRI(bplcon2)) {
+        computeDPFTables<true>();
     } else {
+        computeDPFTables<false>();
+    }
 
-        for (int i = from; i < to; i++) {
-
-             uint8_t s = bBuffer[i];
-
-             assert(PixelEngine::isRgbaIndex(s));
-             iBuffer[i] = mBuffer[i] = (s & 16) ? 16 : s;
-             zBuffer[i] = 0;
-         }
+    for (int s = 0; s < 64; s++) {
+        depthTableLo[s] = LO_BYTE(depthTable[s]);
+        depthTableHi[s] = HI_BYTE(depthTable[s]);
     }
 }
 
 void
-Denise::translateDPF(bool pf2pri, int from, int to)
+Denise::computeSPFTables()
 {
-    pf2pri ? translateDPF<true>(from, to) : translateDPF<false>(from, to);
+    for (int s = 0; s < 64; s++) {
+
+        // The usual case: prio2 is a valid value
+        if (prio2) {
+
+            indexTable[s] = s;
+            depthTable[s] = s ? prio2 : 0;
+
+        // The unusual case: prio2 is invalid
+        } else {
+
+            indexTable[s] = (s & 16) ? 16 : s;
+            depthTable[s] = 0;
+        }
+    }
 }
 
 template <bool pf2pri> void
-Denise::translateDPF(int from, int to)
+Denise::computeDPFTables()
 {
     /* If the priority of a playfield is set to an illegal value (prio1 or
      * prio2 will be 0 in that case), all pixels are drawn transparent.
@@ -643,9 +681,7 @@ Denise::translateDPF(int from, int to)
     uint8_t mask1 = prio1 ? 0b1111 : 0b0000;
     uint8_t mask2 = prio2 ? 0b1111 : 0b0000;
 
-    for (int i = from; i < to; i++) {
-
-        uint8_t s = bBuffer[i];
+    for (int s = 0; s < 64; s++) {
 
         // Determine color indices for both playfields
         uint8_t index1 = (((s & 1) >> 0) | ((s & 4) >> 1) | ((s & 16) >> 2));
@@ -656,37 +692,57 @@ Denise::translateDPF(int from, int to)
 
                 // PF1 is solid, PF2 is solid
                 if (pf2pri) {
-                    iBuffer[i] = mBuffer[i] = (index2 | 0b1000) & mask2;
-                    zBuffer[i] = prio2 | Z_DPF | Z_PF1 | Z_PF2;
+                    indexTable[s] = (index2 | 0b1000) & mask2;
+                    depthTable[s] = prio2 | Z_DPF | Z_PF1 | Z_PF2;
                 } else {
-                    iBuffer[i] = mBuffer[i] = index1 & mask1;
-                    zBuffer[i] = prio1 | Z_DPF | Z_PF1 | Z_PF2;
+                    indexTable[s] = index1 & mask1;
+                    depthTable[s] = prio1 | Z_DPF | Z_PF1 | Z_PF2;
                 }
 
             } else {
 
                 // PF1 is solid, PF2 is transparent
-                iBuffer[i] = mBuffer[i] = index1 & mask1;
-                zBuffer[i] = prio1 | Z_DPF | Z_PF1;
+                indexTable[s] = index1 & mask1;
+                depthTable[s] = prio1 | Z_DPF | Z_PF1;
             }
 
         } else {
             if (index2) {
 
                 // PF1 is transparent, PF2 is solid
-                iBuffer[i] = mBuffer[i] = (index2 | 0b1000) & mask2;
-                zBuffer[i] = prio2 | Z_DPF | Z_PF2;
+                indexTable[s] = (index2 | 0b1000) & mask2;
+                depthTable[s] = prio2 | Z_DPF | Z_PF2;
 
             } else {
 
                 // PF1 is transparent, PF2 is transparent
-                iBuffer[i] = mBuffer[i] = 0;
-                zBuffer[i] = Z_DPF;
+                indexTable[s] = 0;
+                depthTable[s] = Z_DPF;
             }
         }
     }
 }
 
+void
+Denise::translate(int from, int to)
+{
+    // Translate sixteen pixels at once
+    int count = (to - from) & ~15;
+    lookupSSE(bBuffer + from, count, indexTable, iBuffer + from);
+    lookup16SSE(bBuffer + from, count, depthTableLo, depthTableHi, zBuffer + from);
+    memcpy(mBuffer + from, iBuffer + from, count);
+
+    // Translate the remaining pixels
+    for (int i = from + count; i < to; i++) {
+
+        uint8_t s = bBuffer[i];
+
+        assert(PixelEngine::isRgbaIndex(s));
+        iBuffer[i] = mBuffer[i] = indexTable[s & 0x3F];
+        zBuffer[i] = depthTable[s & 0x3F];
+    }
+}
+
 void
 Denise::drawSprites()
 {
@@ -703,6 +759,42 @@ Denise::drawSprites()
     sprRegChanges.clear();
 }
 
+uint32_t
+Denise::chunky(uint16_t data, uint16_t datb)
+{
+    // Interleave the bits of both data registers
+    uint32_t a = data, b = datb;
+
+    a = (a | a << 8) & 0x00FF00FF;
+    a = (a | a << 4) & 0x0F0F0F0F;
+    a = (a | a << 2) & 0x33333333;
+    a = (a | a << 1) & 0x55555555;
+
+    b = (b | b << 8) & 0x00FF00FF;
+    b = (b | b << 4) & 0x0F0F0F0F;
+    b = (b | b << 2) & 0x33333333;
+    b = (b | b << 1) & 0x55555555;
+
+    return a | b << 1;
+}
+
+void
+Denise::addSpan(SpriteSpan *spans, int &count, int start, int end,
+                uint16_t data, uint16_t datb)
+{
+    assert(count < SPR_SPANS);
+
+    // Reloading the shift registers cuts off the previous span
+    if (count && spans[count - 1].stop > start) spans[count - 1].stop = start;
+
+    SpriteSpan &span = spans[count++];
+    span.start = start;
+    span.stop = MIN(start + 32, end);
+    span.data = data;
+    span.datb = datb;
+    span.chunky = chunky(data, datb);
+}
+
 template <int x> void
 Denise::drawSpritePair()
 {
@@ -727,6 +819,42 @@ Denise::drawSpritePair()
     bool armed2 = GET_BIT(arm, x);
     bool at = attached(x);
     int strt = 0;
+    int end = sizeof(mBuffer) - 1;
+
+    // The span lists of both sprites
+    SpriteSpan spans1[SPR_SPANS], spans2[SPR_SPANS];
+    int count1 = 0, count2 = 0;
+
+    // Prepare the collision masks of this sprite pair
+    CollisionLine &clx = clxLines[clxCount];
+    memset(clx.sprite[x-1], 0, sizeof(clx.sprite[x-1]));
+    memset(clx.sprite[x], 0, sizeof(clx.sprite[x]));
+    memset(clx.range[x/2], 0, sizeof(clx.range[x/2]));
+    SET_BIT(clx.pairs, x);
+    int clxStrt = -1;
+
+    // Pixels that have been shifted out at the end of the previous line
+    if (ssra[x-1] | ssrb[x-1]) addSpan(spans1, count1, 0, end, ssra[x-1], ssrb[x-1]);
+    if (ssra[x] | ssrb[x]) addSpan(spans2, count2, 0, end, ssra[x], ssrb[x]);
+
+    // Records the spans of a chunk of pixels with constant register values
+    auto record = [&](int hstrt, int hstop) {
+
+        if (armed1 && strt1 >= hstrt && strt1 < hstop) {
+            addSpan(spans1, count1, strt1, end, data1, datb1);
+        }
+        if (armed2 && strt2 >= hstrt && strt2 < hstop) {
+            addSpan(spans2, count2, strt2, end, data2, datb2);
+        }
+        if (clxStrt != strt1) {
+
+            // Collisions are checked at the odd positions following strt1
+            for (int pos = strt1 + 1; pos <= strt1 + 31 && pos < 64 * CLX_WORDS; pos += 2) {
+                clx.range[x/2][pos >> 6] |= 1ULL << (pos & 63);
+            }
+            clxStrt = strt1;
+        }
+    };
 
     // Iterate over all recorded register changes
     if (!sprRegChanges.isEmpty()) {
@@ -737,11 +865,8 @@ Denise::drawSpritePair()
 
             Change &change = sprRegChanges.change[i];
 
-            // Draw a chunk of pixels
-            drawSpritePair<x>(strt, change.trigger,
-                              strt1, strt2,
-                              data1, data2, datb1, datb2,
-                              armed1,armed2, at);
+            // Record the spans of a chunk of pixels
+            record(strt, change.trigger);
             strt = change.trigger;
 
             // Apply the recorded register change
@@ -783,65 +908,104 @@ Denise::drawSpritePair()
         }
     }
 
-    // Draw until the end of the line
-    drawSpritePair<x>(strt, sizeof(mBuffer) - 1,
-                      strt1, strt2,
-                      data1, data2, datb1, datb2,
-                      armed1, armed2, at);
+    // Record until the end of the line
+    record(strt, end);
+
+    // Draw the spans
+    if (at) {
+        drawAttachedSpans<x>(spans1, count1, spans2, count2);
+    } else {
+        drawSpans<x-1>(spans1, count1);
+        drawSpans<x>(spans2, count2);
+    }
+
+    // Keep the pixels that have not been shifted out in this line
+    keepResidue<x-1>(spans1, count1);
+    keepResidue<x>(spans2, count2);
 }
 
 template <int x> void
-Denise::drawSpritePair(int hstrt, int hstop,
-                       int strt1, int strt2,
-                       uint16_t data1, uint16_t data2,
-                       uint16_t datb1, uint16_t datb2,
-                       bool armed1, bool armed2, bool at)
+Denise::drawSpans(SpriteSpan *spans, int count)
 {
-    assert(hstrt >= 0 && hstrt <= sizeof(mBuffer));
-    assert(hstop >= 0 && hstop <= sizeof(mBuffer));
+    for (int i = 0; i < count; i++) {
 
-    for (int hpos = hstrt; hpos < hstop; hpos += 2) {
+        SpriteSpan &span = spans[i];
 
-        if (hpos == strt1 && armed1) {
-            ssra[x-1] = data1; // sprdata[x-1];
-            ssrb[x-1] = datb1; // sprdatb[x-1];
-        }
-        if (hpos == strt2 && armed2) {
-            ssra[x] = data2; // sprdata[x];
-            ssrb[x] = datb2; // sprdatb[x];
+        // Only visit the pixels inside the clipping window
+        int first = MAX(span.start, (int)spriteClipBegin);
+        int last = MIN(span.stop, (int)spriteClipEnd);
+        first += (first - span.start) & 1;
+
+        for (int hpos = first; hpos < last; hpos += 2) {
+
+            int shift = 30 - (hpos - span.start);
+            drawSpritePixel<x>(hpos, (span.chunky >> shift) & 0b11);
         }
+    }
+}
 
-        if (ssra[x-1] | ssrb[x-1] | ssra[x] | ssrb[x]) {
-            if (hpos >= spriteClipBegin && hpos < spriteClipEnd) {
-                if (at) {
-                    drawAttachedSpritePixelPair<x>(hpos);
-                } else {
-                    drawSpritePixel<x-1>(hpos);
-                    drawSpritePixel<x>(hpos);
-                }
+template <int x> void
+Denise::drawAttachedSpans(SpriteSpan *spans1, int count1,
+                          SpriteSpan *spans2, int count2)
+{
+    int i1 = 0, i2 = 0;
+    int hpos = 0;
+
+    while (true) {
+
+        // Skip all spans that have been completed
+        while (i1 < count1 && spans1[i1].stop <= hpos) i1++;
+        while (i2 < count2 && spans2[i2].stop <= hpos) i2++;
+        if (i1 == count1 && i2 == count2) break;
+
+        // Jump over uncovered pixels
+        int next1 = i1 < count1 ? spans1[i1].start : INT_MAX;
+        int next2 = i2 < count2 ? spans2[i2].start : INT_MAX;
+        if (hpos < MIN(next1, next2)) hpos = MIN(next1, next2);
+
+        if (hpos >= spriteClipEnd) break;
+
+        if (hpos >= spriteClipBegin) {
+
+            uint8_t col1 = 0, col2 = 0;
+
+            if (hpos >= next1) {
+                col1 = (spans1[i1].chunky >> (30 - (hpos - next1))) & 0b11;
             }
-            ssra[x-1] <<= 1;
-            ssrb[x-1] <<= 1;
-            ssra[x] <<= 1;
-            ssrb[x] <<= 1;
+            if (hpos >= next2) {
+                col2 = (spans2[i2].chunky >> (30 - (hpos - next2))) & 0b11;
+            }
+
+            drawAttachedSpritePixelPair<x>(hpos, col1 | col2 << 2);
         }
+
+        hpos += 2;
     }
+}
+
+template <int x> void
+Denise::keepResidue(SpriteSpan *spans, int count)
+{
+    ssra[x] = ssrb[x] = 0;
+
+    if (count == 0) return;
+
+    // Only the last span can reach the end of the line
+    SpriteSpan &span = spans[count - 1];
+    int shifts = (span.stop - span.start + 1) / 2;
 
-    // Perform collision checks (if enabled)
-    if (config.clxSprSpr) checkS2SCollisions<x>(strt1, strt1 + 31);
-    if (config.clxSprPlf) checkS2PCollisions<x>(strt1, strt1 + 31);
+    if (shifts < 16) {
+        ssra[x] = span.data << shifts;
+        ssrb[x] = span.datb << shifts;
+    }
 }
 
 template <int x> void
-Denise::drawSpritePixel(int hpos)
+Denise::drawSpritePixel(int hpos, uint8_t col)
 {
     assert(hpos >= spriteClipBegin);
     assert(hpos < spriteClipEnd);
 
-    uint8_t a = (ssra[x] >> 15);
-    uint8_t b = (ssrb[x] >> 14) & 2;
-    uint8_t col = a | b;
-
     if (col) {
 
         uint16_t z = Z_SP[x];
@@ -851,27 +1015,18 @@ Denise::drawSpritePixel(int hpos)
         if (z > zBuffer[hpos + 1]) mBuffer[hpos + 1] = base | col;
         zBuffer[hpos] |= z;
         zBuffer[hpos + 1] |= z;
+        markSpritePixel<x>(hpos);
+        markSpritePixel<x>(hpos + 1);
     }
 }
 
 template <int x> void
-Denise::drawAttachedSpritePixelPair(int hpos)
+Denise::drawAttachedSpritePixelPair(int hpos, uint8_t col)
 {
     assert(IS_ODD(x));
     assert(hpos >= spriteClipBegin);
     assert(hpos < spriteClipEnd);
 
-    uint8_t a1 = !!GET_BIT(ssra[x-1], 15);
-    uint8_t b1 = !!GET_BIT(ssrb[x-1], 15) << 1;
-    uint8_t a2 = !!GET_BIT(ssra[x], 15) << 2;
-    uint8_t b2 = !!GET_BIT(ssrb[x], 15) << 3;
-    assert(a1 == ((ssra[x-1] >> 15)));
-    assert(b1 == ((ssrb[x-1] >> 14) & 0b0010));
-    assert(a2 == ((ssra[x] >> 13) & 0b0100));
-    assert(b2 == ((ssrb[x] >> 12) & 0b1000));
-
-    uint8_t col = a1 | b1 | a2 | b2;
-
     if (col) {
 
         uint16_t z = Z_SP[x];
@@ -879,10 +1034,12 @@ Denise::drawAttachedSpritePixelPair(int hpos)
         if (z > zBuffer[hpos]) {
             mBuffer[hpos] = 0b10000 | col;
             zBuffer[hpos] |= z;
+            markSpritePixel<x>(hpos);
         }
         if (z > zBuffer[hpos-1]) {
             mBuffer[hpos-1] = 0b10000 | col;
             zBuffer[hpos-1] |= z;
+            markSpritePixel<x>(hpos - 1);
         }
     }
 }
@@ -942,141 +1099,235 @@ Denise::drawBorder()
 #endif
 }
 
-template <int x> void
-Denise::checkS2SCollisions(int start, int end)
-{
-    // For the odd sprites, only proceed if collision detection is enabled
-    if (IS_ODD(x) && !GET_BIT(clxcon, 12 + (x/2))) return;
-
-    // Set up the sprite comparison masks
-    uint16_t comp01 = Z_SP0 | (GET_BIT(clxcon, 12) ? Z_SP1 : 0);
-    uint16_t comp23 = Z_SP2 | (GET_BIT(clxcon, 13) ? Z_SP3 : 0);
-    uint16_t comp45 = Z_SP4 | (GET_BIT(clxcon, 14) ? Z_SP5 : 0);
-    uint16_t comp67 = Z_SP6 | (GET_BIT(clxcon, 15) ? Z_SP7 : 0);
-
-    // Iterate over all sprite pixels
-    for (int pos = end; pos >= start; pos -= 2) {
-
-        uint16_t z = zBuffer[pos];
-
-        // Skip if there are no other sprites at this pixel coordinate
-        if (!(z & (Z_SP01234567 ^ Z_SP[x]))) continue;
-
-        // Skip if the sprite is transparent at this pixel coordinate
-        if (!(z & Z_SP[x])) continue;
-
-        // Set sprite collision bits
-        if ((z & comp45) && (z & comp67)) SET_BIT(clxdat, 14);
-        if ((z & comp23) && (z & comp67)) SET_BIT(clxdat, 13);
-        if ((z & comp23) && (z & comp45)) SET_BIT(clxdat, 12);
-        if ((z & comp01) && (z & comp67)) SET_BIT(clxdat, 11);
-        if ((z & comp01) && (z & comp45)) SET_BIT(clxdat, 10);
-        if ((z & comp01) && (z & comp23)) SET_BIT(clxdat, 9);
-
-        if (CLX_DEBUG == 1) {
-            if ((z & comp45) && (z & comp67)) debug("Collision between 45 and 67\n");
-            if ((z & comp23) && (z & comp67)) debug("Collision between 23 and 67\n");
-            if ((z & comp23) && (z & comp45)) debug("Collision between 23 and 45\n");
-            if ((z & comp01) && (z & comp67)) debug("Collision between 01 and 67\n");
-            if ((z & comp01) && (z & comp45)) debug("Collision between 01 and 45\n");
-            if ((z & comp01) && (z & comp23)) debug("Collision between 01 and 23\n");
+bool
+Denise::isSimpleLine()
+{
+#if defined(BORDER_DEBUG) || defined(LINE_DEBUG)
+    return false;
+#endif
+
+    return
+    conRegChanges.isEmpty() &&
+    pixelEngine.colRegChanges.isEmpty() &&
+    !(wasArmed && config.emulateSprites) &&
+    !ham();
+}
+
+void
+Denise::drawSimpleLine(int vpos)
+{
+    // The playfield mode and priorities are fixed throughout the line
+    bool dual = dbplf(initialBplcon0);
+    updateTranslationTables(dual, initialBplcon2);
+
+    // Set up the dual-playfield mask used for collision checking
+    uint64_t *dpf = clxLines[clxCount].dpf;
+    memset(dpf, 0, sizeof(clxLines[clxCount].dpf));
+    if (dual) setBits(dpf, 0, sizeof(bBuffer));
+
+    // No sprite is drawn in this line
+    sprRegChanges.clear();
+
+    // Determine the pixels inside the display window (see drawBorder())
+    int from = 0, to = 0;
+
+    bool hFlopWasSet = agnus.diwHFlop || agnus.diwHFlopOn != -1;
+    bool lineIsBlank = !agnus.diwVFlop || !hFlopWasSet;
+
+    if (!lineIsBlank) {
+
+        int left = 0, right = HPIXELS;
+
+        if (!agnus.diwHFlop && agnus.diwHFlopOn != -1) {
+            left = MIN(2 * agnus.diwHFlopOn, HPIXELS);
         }
+        if (agnus.diwHFlopOff != -1) {
+            right = MIN(2 * agnus.diwHFlopOff, HPIXELS);
+        }
+
+        from = left;
+        to = MAX(left, right);
     }
+
+    pixelEngine.colorizeSimpleLine(vpos, from, to);
 }
 
-template <int x> void
-Denise::checkS2PCollisions(int start, int end)
+void
+Denise::packPlane(int nr, uint64_t *mask)
 {
-    // For the odd sprites, only proceed if collision detection is enabled
-    if (IS_ODD(x) && !getENSP<x>()) return;
+    assert(nr >= 0 && nr < 6);
 
-    // Set up the sprite comparison mask
-    uint16_t sprMask;
-    switch(x) {
-        case 0:
-        case 1: sprMask = Z_SP0 | (getENSP<1>() ? Z_SP1 : 0); break;
-        case 2:
-        case 3: sprMask = Z_SP2 | (getENSP<3>() ? Z_SP3 : 0); break;
-        case 4:
-        case 5: sprMask = Z_SP4 | (getENSP<5>() ? Z_SP5 : 0); break;
-        case 6:
-        case 7: sprMask = Z_SP6 | (getENSP<7>() ? Z_SP7 : 0); break;
+    const size_t groups = sizeof(bBuffer) / 8;
+
+    // Gather bit 'nr' of eight pixels at once
+    for (size_t i = 0; i < groups; i++) {
 
-        default: sprMask = 0; assert(false);
+        uint64_t v;
+        memcpy(&v, bBuffer + 8 * i, 8);
+        v = (v >> nr) & 0x0101010101010101;
+        uint64_t bits = (v * 0x0102040810204080) >> 56;
+
+        mask[i >> 3] = (i & 7) ? mask[i >> 3] | bits << (8 * (i & 7)) : bits;
     }
 
-    uint8_t enabled1 = getENBP1();
-    uint8_t enabled2 = getENBP2();
-    uint8_t compare1 = getMVBP1() & enabled1;
-    uint8_t compare2 = getMVBP2() & enabled2;
+    // Handle the remaining pixels
+    for (size_t pos = 8 * groups; pos < sizeof(bBuffer); pos++) {
+        if (pos % 64 == 0) mask[pos >> 6] = 0;
+        if (GET_BIT(bBuffer[pos], nr)) mask[pos >> 6] |= 1ULL << (pos & 63);
+    }
 
-    // Check for sprite-playfield collisions
-    for (int pos = end; pos >= start; pos -= 2) {
+    // Clear the words beyond the end of the buffer
+    for (size_t i = (sizeof(bBuffer) + 63) / 64; i < CLX_WORDS; i++) mask[i] = 0;
+}
 
-        uint16_t z = zBuffer[pos];
+void
+Denise::recordCollisions()
+{
+    CollisionLine &line = clxLines[clxCount];
 
-        // Skip if the sprite is transparent at this pixel coordinate
-        if (!(z & Z_SP[x])) continue;
+    line.clxcon = clxcon;
+    line.sprSpr = config.clxSprSpr;
+    line.sprPlf = config.clxSprPlf;
+    line.plfPlf = config.clxPlfPlf;
 
-        // debug(CLX_DEBUG, "<%d> b[%d] = %X e1 = %X e2 = %X, c1 = %X c2 = %X\n",
-        //     x, pos, bBuffer[pos], enabled1, enabled2, compare1, compare2);
+    bool sprites = line.pairs && (line.sprSpr || line.sprPlf);
+    bool playfields = line.plfPlf || (line.pairs && line.sprPlf);
 
-        // Check for a collision with playfield 2
-        if ((bBuffer[pos] & enabled2) == compare2) {
-            debug(CLX_DEBUG, "S%d collides with PF2\n", x);
-            SET_BIT(clxdat, 5 + (x / 2));
-            SET_BIT(clxdat, 1 + (x / 2));
+    // Skip the line if there is nothing to check
+    if (!sprites && !line.plfPlf) { line.pairs = 0; return; }
 
-        } else {
-            // There is a hardware oddity in single-playfield mode. If PF2
-            // doesn't match, playfield 1 doesn't match, too. No matter what.
-            // See http://eab.abime.net/showpost.php?p=965074&postcount=2
-            if ((zBuffer[pos] & Z_DPF) == 0) continue;
-        }
+    // Convert all bitplanes that are compared
+    if (playfields) {
 
-        // Check for a collision with playfield 1
-        if ((bBuffer[pos] & enabled1) == compare1) {
-            debug(CLX_DEBUG, "S%d collides with PF1\n", x);
-            SET_BIT(clxdat, 1 + (x / 2));
-        }
+        uint8_t enabled = (clxcon >> 6) & 0x3F;
+        for (int i = 0; i < 6; i++) if (GET_BIT(enabled, i)) packPlane(i, line.plane[i]);
     }
+
+    // Evaluate the collected lines if the buffer is full
+    if (++clxCount == VPOS_CNT) evaluateCollisions();
+
+    clxLines[clxCount].pairs = 0;
 }
 
 void
-Denise::checkP2PCollisions()
+Denise::evaluateCollisions()
+{
+    uint16_t clx = clxdat;
+
+    for (int i = 0; i < clxCount; i++) clx = evaluateCollisions(clxLines[i], clx);
+
+    clxdat = clx;
+
+    // Continue with an empty buffer
+    clxCount = 0;
+    clxLines[0].pairs = 0;
+}
+
+uint16_t
+Denise::evaluateCollisions(CollisionLine &line, uint16_t clx)
 {
-    // Quick-exit if the collision bit already set
-    if (GET_BIT(clxdat, 0)) return;
+    uint16_t con = line.clxcon;
+
+    // Set up the playfield comparison masks
+    uint8_t enabled1 = (con >> 6) & 0b010101;
+    uint8_t enabled2 = (con >> 6) & 0b101010;
+    uint8_t compare1 = con & 0b010101 & enabled1;
+    uint8_t compare2 = con & 0b101010 & enabled2;
+
+    // Compute the pixels matching the playfield comparison values
+    bool playfields = line.plfPlf || (line.pairs && line.sprPlf);
+    uint64_t match1[CLX_WORDS], match2[CLX_WORDS];
+
+    if (playfields) {
+
+        for (int w = 0; w < CLX_WORDS; w++) match1[w] = match2[w] = ~0ULL;
 
-    // Set up comparison masks
-    uint8_t enabled1 = getENBP1();
-    uint8_t enabled2 = getENBP2();
-    uint8_t compare1 = getMVBP1() & enabled1;
-    uint8_t compare2 = getMVBP2() & enabled2;
+        for (int p = 0; p < 6; p++) {
 
-    // Check all pixels one by one
-    for (int pos = 0; pos < HPIXELS; pos++) {
+            if (!GET_BIT(enabled1 | enabled2, p)) continue;
 
-        uint16_t b = bBuffer[pos];
-        // debug(CLX_DEBUG, "b[%d] = %X e1 = %X e2 = %X c1 = %X c2 = %X\n",
-        //       pos, b, enabled1, enabled2, compare1, compare2);
+            uint64_t *m = GET_BIT(enabled1, p) ? match1 : match2;
+            bool set = GET_BIT(compare1 | compare2, p);
 
-        // Check if there is a hit with playfield 1
-        if ((b & enabled1) != compare1) continue;
+            for (int w = 0; w < CLX_WORDS; w++) {
+                m[w] &= set ? line.plane[p][w] : ~line.plane[p][w];
+            }
+        }
+    }
 
-        // Check if there is a hit with playfield 2
-        if ((b & enabled2) != compare2) continue;
+    // Playfield-playfield collisions (only the visible pixels are checked)
+    if (line.plfPlf && !GET_BIT(clx, 0)) {
 
-        // Set collision bit
-        SET_BIT(clxdat, 0);
-        return;
+        uint64_t hit = 0;
+        for (int w = 0; w < HPIXELS / 64; w++) hit |= match1[w] & match2[w];
+        hit |= match1[HPIXELS / 64] & match2[HPIXELS / 64] & ((1ULL << (HPIXELS % 64)) - 1);
+
+        if (hit) SET_BIT(clx, 0);
     }
+
+    // Sprite collisions (pairs are processed in the order they are drawn)
+    for (int x = 7; x >= 1; x -= 2) {
+
+        if (!GET_BIT(line.pairs, x)) continue;
+
+        // Only proceed if collision detection is enabled for this sprite
+        if (!GET_BIT(con, 12 + (x/2))) continue;
+
+        // Only the pairs that have been drawn before are visible in zBuffer
+        uint64_t *spr[8];
+        uint64_t none[CLX_WORDS] = { };
+        for (int k = 0; k < 8; k++) {
+            spr[k] = (k >= x - 1 && GET_BIT(line.pairs, k | 1)) ? line.sprite[k] : none;
+        }
+
+        for (int w = 0; w < CLX_WORDS; w++) {
+
+            // Pixels where sprite x is solid inside the checked range
+            uint64_t base = line.range[x/2][w] & spr[x][w];
+            if (!base) continue;
+
+            if (line.sprSpr) {
+
+                uint64_t c01 = spr[0][w] | (GET_BIT(con, 12) ? spr[1][w] : 0);
+                uint64_t c23 = spr[2][w] | (GET_BIT(con, 13) ? spr[3][w] : 0);
+                uint64_t c45 = spr[4][w] | (GET_BIT(con, 14) ? spr[5][w] : 0);
+                uint64_t c67 = spr[6][w] | (GET_BIT(con, 15) ? spr[7][w] : 0);
+
+                if (base & c45 & c67) SET_BIT(clx, 14);
+                if (base & c23 & c67) SET_BIT(clx, 13);
+                if (base & c23 & c45) SET_BIT(clx, 12);
+                if (base & c01 & c67) SET_BIT(clx, 11);
+                if (base & c01 & c45) SET_BIT(clx, 10);
+                if (base & c01 & c23) SET_BIT(clx, 9);
+            }
+
+            if (line.sprPlf) {
+
+                /* There is a hardware oddity in single-playfield mode. If PF2
+                 * doesn't match, playfield 1 doesn't match, too. No matter
+                 * what. See http://eab.abime.net/showpost.php?p=965074&postcount=2
+                 */
+                if (base & match2[w]) {
+                    SET_BIT(clx, 5 + (x / 2));
+                    SET_BIT(clx, 1 + (x / 2));
+                }
+                if (base & line.dpf[w] & match1[w]) {
+                    SET_BIT(clx, 1 + (x / 2));
+                }
+            }
+        }
+    }
+
+    return clx;
 }
 
 void
 Denise::beginOfFrame(bool interlace)
 {
     pixelEngine.beginOfFrame(interlace);
+
+    // Compute the collision bits of the previous frame
+    evaluateCollisions();
 }
 
 void
@@ -1119,7 +1370,17 @@ Denise::endOfLine(int vpos)
     // debug("endOfLine pixel = %d HPIXELS = %d\n", pixel, HPIXELS);
 
     // Check if we are below the VBLANK area
-    if (vpos >= 26) {
+    bool vblank = vpos < VBLANK_CNT;
+
+    if (!vblank && isSimpleLine()) {
+
+        // Translate, draw the border, and colorize in a single pass
+        drawSimpleLine(vpos);
+
+        // Record the data needed for collision checking
+        recordCollisions();
+
+    } else if (!vblank) {
 
         // Translate bitplane data to color register indices
         translate();
@@ -1130,8 +1391,8 @@ Denise::endOfLine(int vpos)
         // Draw border pixels
         drawBorder();
 
-        // Perform playfield-playfield collision check (if enabled)
-        if (config.clxPlfPlf) checkP2PCollisions();
+        // Record the data needed for collision checking
+        recordCollisions();
 
         // Synthesize RGBA values and write the result into the frame buffer
         pixelEngine.colorize(vpos);
@@ -1142,6 +1403,9 @@ Denise::endOfLine(int vpos)
 
     // Invoke the DMA debugger
     dmaDebugger.computeOverlay();
+
+    // Hash the completed line (if enabled)
+    pixelEngine.endOfLine(vpos, !vblank);
 }
 
 void
@@ -1368,5 +1632,3 @@ template void Denise::pokeCOLORxx<POKE_COPPER, 31>(uint16_t value);
 template void Denise::draw<0>(int pixels);
 template void Denise::draw<1>(int pixels);
 
-template void Denise::translateDPF<true>(int from, int to);
-template void Denise::translateDPF<false>(int from, int to);
@@ -24,6 +24,9 @@ class Denise : public AmigaComponent {
     // Information shown in the GUI inspector panel
     DeniseInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<DeniseInfo> infoBuffer;
+
     // Statistics shown in the GUI monitor panel
     DeniseStats stats;
 
@@ -79,6 +82,46 @@ public:
     uint16_t clxdat;
     uint16_t clxcon;
 
+    /* Collision detection
+     *
+     * Collisions are not checked pixel by pixel. For each rasterline, Denise
+     * records a couple of bit masks (one bit per pixel) and derives the
+     * CLXDAT bits with wide logical operations. Because most programs never
+     * read CLXDAT, the masks are only evaluated when CLXDAT is read or when
+     * the frame ends. Until then, they are collected in clxLines.
+     */
+    static const int CLX_WORDS = 16;
+
+    struct CollisionLine {
+
+        // The value of CLXCON at the end of the rasterline
+        uint16_t clxcon;
+
+        // The enabled checks (copied from the configuration)
+        bool sprSpr;
+        bool sprPlf;
+        bool plfPlf;
+
+        // Odd sprites whose pair has been drawn (bits 1, 3, 5, 7)
+        uint8_t pairs;
+
+        // Bitplanes 1 to 6 (only the planes enabled in CLXCON are valid)
+        uint64_t plane[6][CLX_WORDS];
+
+        // Pixels drawn in dual-playfield mode
+        uint64_t dpf[CLX_WORDS];
+
+        // Solid pixels of all sprites (mirrors the Z_SPx bits of zBuffer)
+        uint64_t sprite[8][CLX_WORDS];
+
+        // Pixels to check for each sprite pair (indexed by x / 2)
+        uint64_t range[4][CLX_WORDS];
+    };
+
+    // The recorded rasterlines (the current line is stored at clxCount)
+    CollisionLine clxLines[VPOS_CNT];
+    int clxCount = 0;
+
     /* The 6 bitplane parallel-to-serial shift registers
      * Denise transfers the current values of the BPLDAT registers into the
      * shift registers after BPLDAT1 is written to. This is emulated in
@@ -142,6 +185,28 @@ public:
     // Value of variable 'armed' at cycle 0 in the current rasterline
     uint8_t initialArmed;
 
+    /* Sprite spans
+     *
+     * When the shift registers of a sprite are loaded, the sprite draws 16
+     * low resolution pixels, starting at the load position. At the end of
+     * a rasterline, drawSpritePair() converts the recorded register changes
+     * into a list of such spans. Drawing and collision checking only visit
+     * the pixels covered by a span. A span ends early if the shift registers
+     * are reloaded. The pixel data is stored in chunky format (two bits per
+     * pixel, leftmost pixel in the uppermost bits).
+     */
+    struct SpriteSpan {
+
+        int16_t start;
+        int16_t stop;
+        uint16_t data;
+        uint16_t datb;
+        uint32_t chunky;
+    };
+
+    // Maximum number of spans per sprite and rasterline
+    static const int SPR_SPANS = 132;
+
     /* Sprite clipping window
      *
      * The clipping window determines where sprite pixels can be drawn.
@@ -178,11 +243,30 @@ private:
     // Minimum of prio1 and prio2
     uint16_t prio12;
 
+    /* Translation tables
+     * For each of the 64 possible bitplane values, these tables store the
+     * color register index and the z buffer value that translate() writes
+     * into iBuffer, mBuffer, and zBuffer. The tables depend on the playfield
+     * mode and the priority bits in BPLCON2. They are recomputed when one of
+     * these values changes.
+     */
+    uint8_t indexTable[64];
+    uint16_t depthTable[64];
+
+    // The lower and upper bytes of depthTable (looked up with SSE extensions)
+    uint8_t depthTableLo[64];
+    uint8_t depthTableHi[64];
+
+    // The playfield mode and BPLCON2 bits the tables have been computed for
+    int tableConfig = -1;
+
     
     //
     // Rasterline data
     //
 
+public:
+
     /* Four important buffers are involved in the generation of pixel data:
      *
      * bBuffer: The bitplane data buffer
@@ -364,6 +448,8 @@ private:
     size_t _size() override { COMPUTE_SNAPSHOT_SIZE }
     size_t _load(uint8_t *buffer) override { LOAD_SNAPSHOT_ITEMS }
     size_t _save(uint8_t *buffer) override { SAVE_SNAPSHOT_ITEMS }
+    size_t didLoadFromBuffer(uint8_t *buffer) override;
+    size_t willSaveToBuffer(uint8_t *buffer) override;
 
 public:
 
@@ -521,17 +607,22 @@ public:
     void drawLores(int pixels = 16) { draw<0>(pixels); }
     void drawHires(int pixels = 16) { draw<1>(pixels); }
 
-private:
-
     // Translate bitplane data to color register indices
     void translate();
 
-    // Called by translate() in single-playfield mode
-    void translateSPF(int from, int to);
+private:
+
+    // Computes the translation tables for the current playfield mode
+    void updateTranslationTables(bool dual, uint16_t bplcon2);
 
-    // Called by translate() in dual-playfield mode
-    void translateDPF(bool pf2pri, int from, int to);
-    template <bool pf2pri> void translateDPF(int from, int to);
+    // Called by updateTranslationTables() in single-playfield mode
+    void computeSPFTables();
+
+    // Called by updateTranslationTables() in dual-playfield mode
+    template <bool pf2pri> void computeDPFTables();
+
+    // Translates a chunk of bitplane data with the translation tables
+    void translate(int from, int to);
 
 
 public:
@@ -541,35 +632,74 @@ public:
 
     // Draws an armed sprite pair. Called by drawSprites()
     template <int x> void drawSpritePair();
-    template <int x> void drawSpritePair(int hstrt, int hstop,
-                                         int strt1, int strt2,
-                                         uint16_t data1, uint16_t data2,
-                                         uint16_t datb1, uint16_t datb2,
-                                         bool armed1, bool armed2, bool at);
+
+private:
+
+    // Converts the contents of two sprite data registers into chunky format
+    static uint32_t chunky(uint16_t data, uint16_t datb);
+
+    // Appends a span to a span list
+    static void addSpan(SpriteSpan *spans, int &count, int start, int end,
+                        uint16_t data, uint16_t datb);
+
+    // Draws all pixels covered by a span list
+    template <int x> void drawSpans(SpriteSpan *spans, int count);
+    template <int x> void drawAttachedSpans(SpriteSpan *spans1, int count1,
+                                            SpriteSpan *spans2, int count2);
+
+    // Keeps the pixels that have not been drawn until the end of the line
+    template <int x> void keepResidue(SpriteSpan *spans, int count);
 
     // Draws a single sprite pixel
-    template <int x> void drawSpritePixel(int hpos);
-    template <int x> void drawAttachedSpritePixelPair(int hpos);
+    template <int x> void drawSpritePixel(int hpos, uint8_t col);
+    template <int x> void drawAttachedSpritePixelPair(int hpos, uint8_t col);
+
+public:
 
     /* Draws the left and the right border.
      * This method is called at the end of each rasterline.
      */
     void drawBorder(); 
 
+private:
+
+    /* Checks if the current rasterline can be drawn by drawSimpleLine().
+     * This is the case if no control register or color register has been
+     * modified inside the line, no sprite is armed, and HAM mode is off.
+     */
+    bool isSimpleLine();
+
+    /* Draws a rasterline that satisfies isSimpleLine().
+     * Translation, border drawing, and colorization are carried out in a
+     * single pass over the bBuffer. The iBuffer and the zBuffer are not
+     * written, and the mBuffer is only written if line hashing is enabled.
+     */
+    void drawSimpleLine(int vpos);
+
     //
     // Collision checking
     //
 
 public:
 
-    // Checks for sprite-sprite collisions in the current rasterline
-    template <int x> void checkS2SCollisions(int start, int end);
+    // Records the collision masks of the current rasterline
+    void recordCollisions();
+
+    // Computes the CLXDAT bits of all recorded rasterlines
+    void evaluateCollisions();
+
+private:
+
+    // Computes the CLXDAT bits of a single rasterline
+    uint16_t evaluateCollisions(CollisionLine &line, uint16_t clx);
 
-    // Checks for sprite-playfield collisions in the current rasterline
-    template <int x> void checkS2PCollisions(int start, int end);
+    // Converts a bitplane into a bit mask
+    void packPlane(int nr, uint64_t *mask);
 
-    // Checks for playfield-playfield collisions in the current rasterline
-    void checkP2PCollisions();
+    // Marks a solid sprite pixel in the collision masks
+    template <int x> void markSpritePixel(int hpos) {
+        clxLines[clxCount].sprite[x][hpos >> 6] |= 1ULL << (hpos & 63);
+    }
 
 private:
 
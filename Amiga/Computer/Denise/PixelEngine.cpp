@@ -21,6 +21,8 @@ PixelEngine::PixelEngine(Amiga& ref) : AmigaComponent(ref)
 
         shortFrame[i].data = new int[PIXELS];
         shortFrame[i].longFrame = false;
+
+        lineHashes[i].count = 0;
     }
 
     // Create random background noise pattern
@@ -273,6 +275,115 @@ PixelEngine::getStableShortFrame()
     return result;
 }
 
+/* Hashes a buffer of pixels or color indices
+ * The elements are distributed over eight independent 32 bit lanes which are
+ * folded into a single 64 bit value at the end. Because the lanes don't depend
+ * on each other, the compiler is able to vectorize the main loop.
+ */
+template <class T> static uint64_t
+hashBuffer(const T *data, size_t count)
+{
+    uint32_t lane[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        for (int k = 0; k < 8; k++) {
+            lane[k] = (lane[k] ^ (uint32_t)data[i + k]) * 0x01000193;
+            lane[k] ^= lane[k] >> 15;
+        }
+    }
+    for (int k = 0; i < count; i++, k++) {
+        lane[k] = (lane[k] ^ (uint32_t)data[i]) * 0x01000193;
+        lane[k] ^= lane[k] >> 15;
+    }
+
+    // Fold the lanes (64 bit FNV-1a)
+    uint64_t hash = 0xcbf29ce484222325 ^ count;
+    for (int k = 0; k < 8; k++) {
+        hash = (hash ^ lane[k]) * 0x100000001b3;
+    }
+    return hash ^ (hash >> 32);
+}
+
+// Combines the hash values of multiple lines
+static uint64_t
+combineHash(uint64_t hash, uint64_t lineHash)
+{
+    hash = (hash ^ lineHash) * 0x100000001b3;
+    return hash ^ (hash >> 29);
+}
+
+uint64_t
+PixelEngine::hashRegion(int x, int y, int width, int height)
+{
+    assert(x >= 0 && width >= 0 && x + width <= HPIXELS);
+    assert(y >= 0 && height >= 0 && y + height <= VPIXELS);
+
+    uint64_t hash = 0xcbf29ce484222325;
+
+    pthread_mutex_lock(&lock);
+
+    LineHashes &hashes = lineHashes[stableLongFrame == &longFrame[1]];
+    bool precomputed = lineHashing && x == 0 && width == HPIXELS;
+
+    for (int row = y; row < y + height; row++) {
+
+        if (precomputed && row < hashes.count) {
+            hash = combineHash(hash, hashes.rgba[row]);
+        } else {
+            uint32_t *pixel = (uint32_t *)stableLongFrame->data + row * HPIXELS + x;
+            hash = combineHash(hash, hashBuffer(pixel, width));
+        }
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    return hash;
+}
+
+bool
+PixelEngine::hashIndexLines(int y, int height, uint64_t &hash)
+{
+    assert(y >= 0 && height >= 0 && y + height <= VPIXELS);
+
+    bool available;
+    hash = 0xcbf29ce484222325;
+
+    pthread_mutex_lock(&lock);
+
+    LineHashes &hashes = lineHashes[stableLongFrame == &longFrame[1]];
+    available = lineHashing && y + height <= hashes.count;
+
+    for (int row = y; available && row < y + height; row++) {
+        available = hashes.indexed[row];
+        hash = combineHash(hash, hashes.index[row]);
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    return available;
+}
+
+void
+PixelEngine::hashLine(int line, bool indexed)
+{
+    // Only long frames are hashed
+    if (!isLongFrame(frameBuffer)) return;
+
+    LineHashes &hashes = lineHashes[frameBuffer == &longFrame[1]];
+
+    // Only proceed if all previous lines have been hashed
+    if (line != hashes.count) return;
+
+    uint32_t *pixel = (uint32_t *)frameBuffer->data + line * HPIXELS;
+    hashes.rgba[line] = hashBuffer(pixel, HPIXELS);
+
+    hashes.indexed[line] = indexed;
+    hashes.index[line] = indexed ? hashBuffer(denise.mBuffer, HPIXELS) : 0;
+
+    hashes.count++;
+}
+
 int32_t *
 PixelEngine::getNoise()
 {
@@ -324,6 +435,11 @@ PixelEngine::beginOfFrame(bool interlace)
     }
 
     frameBuffer->interlace = interlace;
+
+    // Start over with hashing lines
+    if (isLongFrame(frameBuffer)) {
+        lineHashes[frameBuffer == &longFrame[1]].count = 0;
+    }
     
     pthread_mutex_unlock(&lock);
 
@@ -398,6 +514,60 @@ PixelEngine::colorize(int line)
 
     // Clear the history cache
     colRegChanges.clear(); 
+
+    amiga.counters.colorizedLines++;
+}
+
+void
+PixelEngine::colorizeSimpleLine(int line, int from, int to)
+{
+    assert(0 <= from && from <= to && to <= HPIXELS);
+
+    // Jump to the first pixel in the specified line in the active frame buffer
+    int32_t *dst = frameBuffer->data + line * HPIXELS;
+
+    // Color indices are only needed for computing line hashes
+    if (lineHashing) {
+        colorizeSimpleLine<true>(dst, from, to);
+    } else {
+        colorizeSimpleLine<false>(dst, from, to);
+    }
+
+    // Wipe out the HBLANK area
+    for (int pixel = 4 * 0x0F; pixel <= 4 * 0x35; pixel++) {
+        dst[pixel] = rgbaHBlank;
+    }
+
+    amiga.counters.colorizedLines++;
+}
+
+template <bool index> void
+PixelEngine::colorizeSimpleLine(int *dst, int from, int to)
+{
+    uint8_t *bbuf = denise.bBuffer;
+    uint8_t *mbuf = denise.mBuffer;
+    uint8_t *table = denise.indexTable;
+    int32_t border = indexedRgba[0];
+
+    // Left border
+    for (int i = 0; i < from; i++) {
+        dst[i] = border;
+        if (index) mbuf[i] = 0;
+    }
+
+    // Display window
+    for (int i = from; i < to; i++) {
+
+        uint8_t nr = table[bbuf[i] & 0x3F];
+        dst[i] = indexedRgba[nr];
+        if (index) mbuf[i] = nr;
+    }
+
+    // Right border
+    for (int i = to; i < HPIXELS; i++) {
+        dst[i] = border;
+        if (index) mbuf[i] = 0;
+    }
 }
 
 void
@@ -54,6 +54,36 @@ private:
     // Buffer storing background noise (random black and white pixels)
     int32_t *noise;
 
+
+    //
+    // Line hashes
+    //
+
+    /* Hash values of the lines of a long frame buffer
+     * If line hashing is enabled, each line of a long frame is hashed right
+     * after it has been drawn. Besides the RGBA values, the color indices of
+     * the mBuffer are hashed, too, which makes it possible to check the
+     * screen contents independent of the color palette. Lines are hashed in
+     * sequential order, starting with line 0. 'count' is the number of lines
+     * that have been hashed so far.
+     */
+    struct LineHashes {
+
+        uint64_t rgba[VPIXELS];
+        uint64_t index[VPIXELS];
+
+        // Indicates if index[] is valid (lines in the VBLANK area have none)
+        bool indexed[VPIXELS];
+
+        int count;
+    };
+
+    // Line hashes for both long frame buffers
+    LineHashes lineHashes[2];
+
+    // Indicates if lines are hashed while being drawn
+    bool lineHashing = false;
+
     //
     // Color management
     //
@@ -209,6 +239,35 @@ public:
     // Returns the stable frame buffer for short frames
     ScreenBuffer getStableShortFrame();
 
+    /* Computes a hash value for a rectangular region of the stable long frame
+     * The function is intended for automated tests that need to check if
+     * something specific is displayed on the screen. If line hashing is
+     * enabled, regions spanning the whole width of the frame buffer are
+     * hashed by combining the precomputed line hashes.
+     */
+    uint64_t hashRegion(int x, int y, int width, int height);
+
+    /* Computes a hash value for the color indices of some lines of the stable
+     * long frame. The function requires line hashing to be enabled and
+     * returns false if the index data of the requested lines isn't available.
+     */
+    bool hashIndexLines(int y, int height, uint64_t &hash);
+
+    // Enables or disables line hashing
+    bool getLineHashing() { return lineHashing; }
+    void setLineHashing(bool value) { lineHashing = value; }
+
+    /* Hashes a line that has been drawn completely (called by Denise)
+     * 'indexed' is false for lines without color indices in the mBuffer.
+     */
+    void endOfLine(int line, bool indexed) { if (lineHashing) hashLine(line, indexed); }
+
+private:
+
+    void hashLine(int line, bool indexed);
+
+public:
+
     // Returns a pointer to randon noise
     int32_t *getNoise();
 
@@ -245,8 +304,17 @@ public:
      */
     void colorize(int line);
 
+    /* Translates and colorizes a rasterline in a single pass.
+     * This function is called by Denise for lines without any register
+     * changes, sprites, or HAM pixels. It reads the bBuffer directly and
+     * draws all pixels outside [from; to) in the background color.
+     */
+    void colorizeSimpleLine(int line, int from, int to);
+
 private:
 
+    template <bool index> void colorizeSimpleLine(int *dst, int from, int to);
+
     void colorize(int *dst, int from, int to);
     void colorizeHAM(int *dst, int from, int to, uint16_t& ham);
 
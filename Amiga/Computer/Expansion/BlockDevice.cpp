@@ -0,0 +1,387 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+BlockDevice::BlockDevice(Amiga& ref) : AmigaComponent(ref)
+{
+    setDescription("BlockDevice");
+
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+BlockDevice::~BlockDevice()
+{
+    release();
+
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+void
+BlockDevice::_dump()
+{
+    if (!isAttached()) {
+        msg("No image attached\n");
+        return;
+    }
+
+    msg("     Image: %d blocks (%s)\n", numBlocks(), readOnly ? "read-only" : "read/write");
+    msg("     State: %s\n",
+        state == BOARD_CONFIGURED ? "configured" :
+        state == BOARD_SHUTUP ? "shut up" : "unconfigured");
+    msg("      Base: %06X\n", base);
+    msg("     Block: %d\n", block);
+    msg("     Count: %d\n", count);
+    msg("   Address: %06X\n", address);
+    msg("   Command: %d (%s)\n", command, error ? "failed" : "ok");
+}
+
+bool
+BlockDevice::attach(const char *path)
+{
+    struct stat fileProperties;
+
+    assert(path != NULL);
+
+    amiga.suspend();
+    detach();
+
+    // Open the image (fall back to read-only mode if necessary)
+    readOnly = false;
+    if ((fd = open(path, O_RDWR)) < 0) {
+        readOnly = true;
+        fd = open(path, O_RDONLY);
+    }
+    if (fd < 0) {
+        warn("Cannot open %s\n", path);
+        amiga.resume();
+        return false;
+    }
+
+    // Check the image size
+    if (fstat(fd, &fileProperties) != 0 ||
+        fileProperties.st_size == 0 || fileProperties.st_size % blockSize != 0) {
+
+        warn("%s is not a valid block device image\n", path);
+        close(fd);
+        fd = -1;
+        amiga.resume();
+        return false;
+    }
+
+    // Map the image into memory (changes go to the image file)
+    int prot = readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void *addr = mmap(NULL, (size_t)fileProperties.st_size, prot, MAP_SHARED, fd, 0);
+
+    if (addr == MAP_FAILED) {
+
+        warn("Cannot map %s\n", path);
+        close(fd);
+        fd = -1;
+        amiga.resume();
+        return false;
+    }
+
+    image = (uint8_t *)addr;
+    imageSize = (size_t)fileProperties.st_size;
+
+    // Launch the worker thread
+    quit = false;
+    prefetchStart = prefetchEnd = 0;
+    dirtyStart = dirtyEnd = 0;
+    pthread_create(&thread, NULL, workerMain, (void *)this);
+
+    // Start by prefetching the beginning of the image
+    prefetch(0, readAhead * blockSize);
+
+    debug("Attached %s (%d blocks)\n", path, numBlocks());
+
+    amiga.resume();
+    return true;
+}
+
+void
+BlockDevice::detach()
+{
+    if (!isAttached()) return;
+
+    amiga.suspend();
+    release();
+    amiga.resume();
+}
+
+void
+BlockDevice::release()
+{
+    if (!isAttached()) return;
+
+    // Stop the worker thread
+    pthread_mutex_lock(&lock);
+    quit = true;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+    pthread_join(thread, NULL);
+
+    // Write back all modifications
+    if (!readOnly) msync(image, imageSize, MS_SYNC);
+
+    munmap(image, imageSize);
+    close(fd);
+
+    image = NULL;
+    imageSize = 0;
+    fd = -1;
+}
+
+uint8_t
+BlockDevice::peek8(uint32_t addr)
+{
+    uint16_t value = peekReg(addr & 0xFFFE);
+    return IS_ODD(addr) ? LO_BYTE(value) : HI_BYTE(value);
+}
+
+void
+BlockDevice::poke8(uint32_t addr, uint8_t value)
+{
+    uint32_t offset = addr & 0xFFFE;
+    uint16_t old = peekReg(offset);
+
+    if (IS_ODD(addr)) {
+        pokeReg(offset, HI_LO(HI_BYTE(old), value));
+    } else {
+        pokeReg(offset, HI_LO(value, LO_BYTE(old)));
+        return;
+    }
+
+    // Writing the low byte of the command register triggers the command
+    if (offset == 0x0C) execute(command);
+}
+
+uint16_t
+BlockDevice::peekReg(uint32_t offset)
+{
+    switch (offset) {
+
+        case 0x00: return
+            (isAttached() ? 0x8000 : 0) | (readOnly ? 0x0002 : 0) | (error ? 0x0001 : 0);
+
+        case 0x02: return HI_WORD(block);
+        case 0x04: return LO_WORD(block);
+        case 0x06: return count;
+        case 0x08: return HI_WORD(address);
+        case 0x0A: return LO_WORD(address);
+        case 0x0C: return command;
+        case 0x0E: return HI_WORD(numBlocks());
+        case 0x10: return LO_WORD(numBlocks());
+
+        default: return 0;
+    }
+}
+
+void
+BlockDevice::pokeReg(uint32_t offset, uint16_t value)
+{
+    switch (offset) {
+
+        case 0x02: block = REPLACE_HI_WORD(block, (uint32_t)value); return;
+        case 0x04: block = REPLACE_LO_WORD(block, value); return;
+        case 0x06: count = value; return;
+        case 0x08: address = REPLACE_HI_WORD(address, (uint32_t)value); return;
+        case 0x0A: address = REPLACE_LO_WORD(address, value); return;
+        case 0x0C: command = value; return;
+
+        default: return;
+    }
+}
+
+void
+BlockDevice::execute(uint16_t cmd)
+{
+    debug(2, "execute(%d) block = %d count = %d address = %X\n", cmd, block, count, address);
+
+    switch (cmd) {
+
+        case CMD_READ:
+
+            error = !transfer(false);
+            break;
+
+        case CMD_WRITE:
+
+            error = readOnly || !transfer(true);
+            break;
+
+        case CMD_FLUSH:
+
+            if (isAttached()) flush();
+            error = !isAttached();
+            break;
+
+        default:
+
+            warn("Unknown command: %d\n", cmd);
+            error = true;
+    }
+}
+
+bool
+BlockDevice::transfer(bool write)
+{
+    if (!isAttached()) return false;
+
+    // Check the block range
+    if ((size_t)block + count > numBlocks()) {
+        warn("Blocks %d - %d are out of range\n", block, block + count - 1);
+        return false;
+    }
+
+    size_t start = (size_t)block * blockSize;
+    size_t length = (size_t)count * blockSize;
+    uint32_t ramAddr = address & 0xFFFFFF;
+
+    if (length == 0) return true;
+
+    // Copy data bank by bank (the Ram of a bank is contiguous on the host)
+    for (size_t done = 0; done < length; ) {
+
+        size_t chunk = MIN(length - done, 0x10000 - (ramAddr & 0xFFFF));
+        uint8_t *ram = mem.ramPtr(ramAddr);
+
+        if (ram == NULL) {
+            warn("No Ram at address %06X\n", ramAddr);
+            return false;
+        }
+
+        if (write) {
+            memcpy(image + start + done, ram, chunk);
+        } else {
+            memcpy(ram, image + start + done, chunk);
+        }
+
+        done += chunk;
+        ramAddr = (ramAddr + chunk) & 0xFFFFFF;
+    }
+
+    if (write) {
+
+        // Write the modified pages back in the background
+        markDirty(start, start + length);
+
+    } else {
+
+        // Prefetch the blocks that are likely to be read next
+        prefetch(start + length, start + length + readAhead * blockSize);
+    }
+
+    return true;
+}
+
+void *
+BlockDevice::workerMain(void *device)
+{
+    ((BlockDevice *)device)->workerLoop();
+    return NULL;
+}
+
+void
+BlockDevice::workerLoop()
+{
+    size_t pageSize = (size_t)getpagesize();
+
+    pthread_mutex_lock(&lock);
+
+    while (!quit) {
+
+        // Wait for work
+        if (prefetchStart == prefetchEnd && dirtyStart == dirtyEnd) {
+            pthread_cond_wait(&cond, &lock);
+            continue;
+        }
+
+        // Grab all pending requests
+        size_t pStart = prefetchStart, pEnd = prefetchEnd;
+        size_t dStart = dirtyStart, dEnd = dirtyEnd;
+        prefetchStart = prefetchEnd = 0;
+        dirtyStart = dirtyEnd = 0;
+
+        pthread_mutex_unlock(&lock);
+
+        // Write back modified pages
+        if (dStart != dEnd) {
+
+            size_t from = dStart & ~(pageSize - 1);
+            msync(image + from, dEnd - from, MS_SYNC);
+        }
+
+        // Pull the prefetch range into the page cache
+        if (pStart != pEnd) {
+
+            size_t from = pStart & ~(pageSize - 1);
+            madvise(image + from, pEnd - from, MADV_WILLNEED);
+
+            // Touch each page to make sure it is resident
+            volatile uint8_t sum = 0;
+            for (size_t i = from; i < pEnd; i += pageSize) sum += image[i];
+        }
+
+        pthread_mutex_lock(&lock);
+    }
+
+    pthread_mutex_unlock(&lock);
+}
+
+void
+BlockDevice::prefetch(size_t start, size_t end)
+{
+    end = MIN(end, imageSize);
+    if (start >= end) return;
+
+    // A new prefetch request supersedes the old one
+    pthread_mutex_lock(&lock);
+    prefetchStart = start;
+    prefetchEnd = end;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+BlockDevice::markDirty(size_t start, size_t end)
+{
+    assert(start < end && end <= imageSize);
+
+    // Merge the range into the pending write-back range
+    pthread_mutex_lock(&lock);
+    if (dirtyStart == dirtyEnd) {
+        dirtyStart = start;
+        dirtyEnd = end;
+    } else {
+        dirtyStart = MIN(dirtyStart, start);
+        dirtyEnd = MAX(dirtyEnd, end);
+    }
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+BlockDevice::flush()
+{
+    assert(isAttached());
+
+    if (readOnly) return;
+
+    // Pending write-back requests are covered by the synchronous write below
+    pthread_mutex_lock(&lock);
+    dirtyStart = dirtyEnd = 0;
+    pthread_mutex_unlock(&lock);
+
+    msync(image, imageSize, MS_SYNC);
+    fsync(fd);
+}
@@ -0,0 +1,239 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _BLOCK_DEVICE_INC
+#define _BLOCK_DEVICE_INC
+
+#include "AmigaComponent.h"
+
+/* Emulated block device (Zorro II I/O board)
+ *
+ * The block device provides fast access to a raw disk image on the host. It
+ * is an auto-config board with a 64 KB I/O space which is visible to the
+ * Amiga once an image has been attached. Kickstart maps the board into the
+ * Zorro II I/O area (0xE90000 - 0xEFFFFF). Data is transferred between the
+ * image and Chip, Slow, or Fast Ram in a single step, i.e., no MFM encoding
+ * or disk DMA is involved. The following registers are provided:
+ *
+ *     Offset  Name     Access  Description
+ *     0x00    STATUS   R       Bit 15: Image attached
+ *                              Bit 1:  Image is read-only
+ *                              Bit 0:  Last command failed
+ *     0x02    BLOCKHI  R/W     First block (bits 31 - 16)
+ *     0x04    BLOCKLO  R/W     First block (bits 15 - 0)
+ *     0x06    COUNT    R/W     Number of blocks to transfer
+ *     0x08    ADDRHI   R/W     Ram address (bits 31 - 16)
+ *     0x0A    ADDRLO   R/W     Ram address (bits 15 - 0)
+ *     0x0C    COMMAND  R/W     1 = Read, 2 = Write, 3 = Flush
+ *     0x0E    SIZEHI   R       Number of blocks in the image (bits 31 - 16)
+ *     0x10    SIZELO   R       Number of blocks in the image (bits 15 - 0)
+ *
+ * A command is executed when the low byte of the command register is
+ * written. Transfers complete immediately, hence there is no busy state.
+ *
+ * The image is memory-mapped. A worker thread keeps the emulator thread
+ * from blocking on the host file system: After a read, it prefetches the
+ * blocks following the transferred ones. After a write, it writes the
+ * modified pages back to the image file.
+ *
+ * The image is not part of a snapshot.
+ */
+class BlockDevice : public AmigaComponent {
+
+    friend class ZorroManager;
+
+    // Size of a single block in bytes
+    static const size_t blockSize = 512;
+
+    // Number of blocks to prefetch after a read command
+    static const size_t readAhead = 256;
+
+    // Commands
+    static const uint16_t CMD_READ = 1;
+    static const uint16_t CMD_WRITE = 2;
+    static const uint16_t CMD_FLUSH = 3;
+
+
+    //
+    // Host image
+    //
+
+    // File descriptor of the attached image (-1 if no image is attached)
+    int fd = -1;
+
+    // The memory-mapped image
+    uint8_t *image = NULL;
+
+    // Size of the image in bytes
+    size_t imageSize = 0;
+
+    // Indicates if the image has been opened read-only
+    bool readOnly = false;
+
+
+    //
+    // Worker thread
+    //
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    // Indicates if the worker thread is supposed to terminate
+    bool quit = false;
+
+    // Byte range to prefetch (empty if start == end)
+    size_t prefetchStart = 0;
+    size_t prefetchEnd = 0;
+
+    // Byte range that has been written and needs to go back to disk
+    size_t dirtyStart = 0;
+    size_t dirtyEnd = 0;
+
+
+    //
+    // Auto-config state
+    //
+
+    // The current configuration state of the board
+    BoardState state;
+
+    // Base address of the board (value is provided by Kickstart)
+    uint32_t base;
+
+
+    //
+    // Registers
+    //
+
+    uint32_t block;
+    uint16_t count;
+    uint32_t address;
+    uint16_t command;
+    bool error;
+
+
+    //
+    // Constructing and destructing
+    //
+
+public:
+
+    BlockDevice(Amiga& ref);
+    ~BlockDevice();
+
+
+    //
+    // Iterating over snapshot items
+    //
+
+    template <class T>
+    void applyToPersistentItems(T& worker)
+    {
+    }
+
+    template <class T>
+    void applyToResetItems(T& worker)
+    {
+        worker
+
+        & state
+        & base
+        & block
+        & count
+        & address
+        & command
+        & error;
+    }
+
+
+    //
+    // Methods from HardwareComponent
+    //
+
+private:
+
+    void _reset() override { RESET_SNAPSHOT_ITEMS }
+    void _dump() override;
+    size_t _size() override { COMPUTE_SNAPSHOT_SIZE }
+    size_t _load(uint8_t *buffer) override { LOAD_SNAPSHOT_ITEMS }
+    size_t _save(uint8_t *buffer) override { SAVE_SNAPSHOT_ITEMS }
+
+
+    //
+    // Managing images
+    //
+
+public:
+
+    // Attaches a raw disk image (the size must be a multiple of 512 bytes)
+    bool attach(const char *path);
+
+    // Writes back all modifications and detaches the image
+    void detach();
+
+private:
+
+    // Stops the worker thread and unmaps the image
+    void release();
+
+public:
+
+    // Indicates if an image is attached
+    bool isAttached() { return image != NULL; }
+
+    // Returns the number of blocks in the attached image
+    size_t numBlocks() { return imageSize / blockSize; }
+
+    // Indicates if the board is mapped into the I/O space
+    bool isMapped() { return isAttached() && state == BOARD_CONFIGURED; }
+
+    // Returns the base address of the board
+    uint32_t getBase() { return base; }
+
+
+    //
+    // Accessing registers
+    //
+
+    uint8_t peek8(uint32_t addr);
+    void poke8(uint32_t addr, uint8_t value);
+
+private:
+
+    uint16_t peekReg(uint32_t offset);
+    void pokeReg(uint32_t offset, uint16_t value);
+
+
+    //
+    // Executing commands
+    //
+
+    void execute(uint16_t cmd);
+
+    // Copies blocks between the image and Amiga memory
+    bool transfer(bool write);
+
+
+    //
+    // Running the worker thread
+    //
+
+    static void *workerMain(void *device);
+    void workerLoop();
+
+    // Hands a prefetch request or a write-back request to the worker
+    void prefetch(size_t start, size_t end);
+    void markDirty(size_t start, size_t end);
+
+    // Writes back all modifications synchronously
+    void flush();
+};
+
+#endif
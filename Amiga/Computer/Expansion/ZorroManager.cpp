@@ -12,6 +12,13 @@
 ZorroManager::ZorroManager(Amiga& ref) : AmigaComponent(ref)
 {
     setDescription("ZorroManager");
+
+    subComponents = vector<HardwareComponent *> {
+
+        &blockDevice
+    };
+
+    memset(boardSize, 0, sizeof(boardSize));
 }
 
 void
@@ -29,19 +36,100 @@ ZorroManager::_ping()
 void
 ZorroManager::_dump()
 {
-    
+    for (int i = 0; i < ZORRO_BOARDS; i++) {
+
+        if (boardSize[i] == 0) continue;
+
+        msg("Board %d: %4d KB at offset %06X ", i, boardSize[i] / 1024, getBoardOffset(i));
+
+        switch (boardState[i]) {
+            case BOARD_UNCONFIGURED: plainmsg("(unconfigured)\n"); break;
+            case BOARD_CONFIGURED: plainmsg("(mapped to %06X)\n", boardBase[i]); break;
+            case BOARD_SHUTUP: plainmsg("(shut up)\n"); break;
+        }
+    }
+}
+
+ZorroConfig
+ZorroManager::getConfig()
+{
+    ZorroConfig config;
+
+    for (int i = 0; i < ZORRO_BOARDS; i++) config.boardSize[i] = boardSize[i];
+
+    return config;
+}
+
+bool
+ZorroManager::setBoardSize(int nr, size_t size)
+{
+    assert(nr >= 0 && nr < ZORRO_BOARDS);
+
+    if (!isValidBoardSize(size)) {
+        warn("Invalid board size: %d\n", size);
+        return false;
+    }
+    if (totalSize() - boardSize[nr] + size > MB(8)) {
+        warn("Fast Ram of all boards exceeds 8 MB\n");
+        return false;
+    }
+
+    boardSize[nr] = (uint32_t)size;
+    return mem.allocFast(totalSize());
+}
+
+size_t
+ZorroManager::totalSize()
+{
+    size_t result = 0;
+
+    for (int i = 0; i < ZORRO_BOARDS; i++) result += boardSize[i];
+
+    return result;
+}
+
+size_t
+ZorroManager::getBoardOffset(int nr)
+{
+    assert(nr >= 0 && nr < ZORRO_BOARDS);
+
+    size_t result = 0;
+
+    for (int i = 0; i < nr; i++) result += boardSize[i];
+
+    return result;
+}
+
+int
+ZorroManager::currentBoard()
+{
+    for (int i = 0; i < ZORRO_BOARDS; i++) {
+        if (boardSize[i] && boardState[i] == BOARD_UNCONFIGURED) return i;
+    }
+
+    // The block device is configured after all Ram boards
+    if (blockDevice.isAttached() && blockDevice.state == BOARD_UNCONFIGURED) {
+        return ZORRO_BOARDS;
+    }
+
+    return -1;
 }
 
 uint8_t
-ZorroManager::peekFastRamDevice(uint32_t addr)
+ZorroManager::peekAutoConf(uint32_t addr)
 {
-    size_t fastRamSize = mem.config.fastSize;
-    
-    debug(2, "    peekFastRamDevice(%X)\n", addr & 0xFFFF);
-    debug(2, "    fastRamSize = %d\n", fastRamSize);
-    // assert(false);
+    debug(2, "    peekAutoConf(%X)\n", addr & 0xFFFF);
+
+    autoConfData = spypeekAutoConf(addr);
+    return autoConfData;
+}
+
+uint8_t
+ZorroManager::spypeekAutoConf(uint32_t addr)
+{
+    int nr = currentBoard();
 
-    if (fastRamConf || fastRamSize == 0) return 0xF; // Already configured
+    if (nr < 0) return 0xF; // All boards are configured
     
     /* Register pair 00/02 (er_Type)
      *
@@ -63,19 +151,32 @@ ZorroManager::peekFastRamDevice(uint32_t addr)
      *              110 = 2 megabytes
      *              111 = 4 megabytes
      */
-    uint8_t erTypeHi = 0b1110; // Zorro II, Free pool, Don't boot
+    uint8_t erTypeHi;
     uint8_t erTypeLo;
-    
-    switch (fastRamSize) {
-        case KB(64):  erTypeLo = 0b001; break;
-        case KB(128): erTypeLo = 0b010; break;
-        case KB(256): erTypeLo = 0b011; break;
-        case KB(512): erTypeLo = 0b100; break;
-        case MB(1):   erTypeLo = 0b101; break;
-        case MB(2):   erTypeLo = 0b110; break;
-        case MB(4):   erTypeLo = 0b111; break;
-        case MB(8):   erTypeLo = 0b000; break;
-        default: assert(false);
+    uint8_t erProductLo;
+
+    if (nr == ZORRO_BOARDS) {
+
+        erTypeHi = 0b1100; // Zorro II, No memory, Don't boot
+        erTypeLo = 0b001;  // 64 KB of I/O space
+        erProductLo = 0x7;
+
+    } else {
+
+        erTypeHi = 0b1110; // Zorro II, Free pool, Don't boot
+        erProductLo = 0x8;
+
+        switch (boardSize[nr]) {
+            case KB(64):  erTypeLo = 0b001; break;
+            case KB(128): erTypeLo = 0b010; break;
+            case KB(256): erTypeLo = 0b011; break;
+            case KB(512): erTypeLo = 0b100; break;
+            case MB(1):   erTypeLo = 0b101; break;
+            case MB(2):   erTypeLo = 0b110; break;
+            case MB(4):   erTypeLo = 0b111; break;
+            case MB(8):   erTypeLo = 0b000; break;
+            default: assert(false);
+        }
     }
     
     /* Register pair 08/0A (er_flags) Note: Bits must be returned negated.
@@ -88,98 +189,105 @@ ZorroManager::peekFastRamDevice(uint32_t addr)
      */
     uint8_t erFlagsHi = 0b0111;
     uint8_t erFlagsLo = 0b1111; // Logical and size match
+    uint8_t result;
     
     switch (addr & 0xFFFF) {
             
         case 0x00: // er_Type (upper nibble)
-            if (fastRamConf == 0) autoConfData = erTypeHi;
+            result = erTypeHi;
             break;
             
         case 0x02: // er_Type (lower nibble)
-            if (fastRamConf == 0) autoConfData = erTypeLo;
+            result = erTypeLo;
             break;
             
         case 0x04: // er_Product (upper nibble)
-            autoConfData = 0x9;
+            result = 0x9;
             break;
             
         case 0x06: // er_Product (lower nibble)
-            if (fastRamConf == 0) autoConfData = 0x8;
+            result = erProductLo;
             break;
             
         case 0x08: // er_Flags (upper nibble)
-            autoConfData = erFlagsHi;
+            result = erFlagsHi;
             break;
             
         case 0x0A: // er_Flags (lower nibble)
-            autoConfData = erFlagsLo;
+            result = erFlagsLo;
             break;
             
         case 0x0C: case 0x0E: // er_Reserved03 (must be 0)
-            autoConfData = 0xF;
+            result = 0xF;
             break;
             
         case 0x10: // er_Manufacturer (upper nibble of high byte)
-            autoConfData = 0xF;
+            result = 0xF;
             break;
             
         case 0x12: // er_Manufacturer (lower nibble of high byte)
-            autoConfData = 0x8;
+            result = 0x8;
             break;
             
         case 0x14: // er_Manufacturer (upper nibble of low byte)
-            autoConfData = 0x4;
+            result = 0x4;
             break;
             
         case 0x16: // er_Manufacturer (lower nibble of low byte)
-            autoConfData = 0x6;
+            result = 0x6;
             break;
             
         case 0x18: // er_SerialNumber (upper nibble of byte 0 (msb))
-            autoConfData = 0xA;
+            result = 0xA;
             break;
             
         case 0x1A: // er_SerialNumber (lower nibble of byte 0 (msb))
-            autoConfData = 0xF;
+            result = 0xF;
             break;
             
         case 0x1C: // er_SerialNumber (upper nibble of byte 1)
-            autoConfData = 0xB;
+            result = 0xB;
             break;
             
         case 0x1E: // er_SerialNumber (lower nibble of byte 1)
-            autoConfData = 0xE;
+            result = 0xE;
             break;
             
         case 0x20: // er_SerialNumber (upper nibble of byte 2)
-            autoConfData = 0xA;
+            result = 0xA;
             break;
             
         case 0x22: // er_SerialNumber (lower nibble of byte 2)
-            autoConfData = 0xA;
+            result = 0xA;
             break;
             
         case 0x24: // er_SerialNumber (upper nibble of byte 3 (lsb))
-            autoConfData = 0xB;
+            result = 0xB;
             break;
             
         case 0x26: // er_SerialNumber (lower nibble of byte 3 (lsb))
-            autoConfData = 0x3;
+            result = 0x3 + nr; // Each board has its own serial number
             break;
             
         default:
-            autoConfData = 0xF;
+            result = 0xF;
     }
     
-    return autoConfData;
+    return result;
 }
 
 void
-ZorroManager::pokeFastRamDevice(uint32_t addr, uint8_t value)
+ZorroManager::pokeAutoConf(uint32_t addr, uint8_t value)
 {
-    if (mem.config.fastSize == 0) return;
-    
-    // debug("pokeFastRamDevice(%X, %X)\n", addr, value);
+    int nr = currentBoard();
+
+    debug(2, "pokeAutoConf(%X, %X) board = %d\n", addr, value, nr);
+
+    if (nr < 0) return;
+
+    bool io = nr == ZORRO_BOARDS;
+    uint32_t &base = io ? blockDevice.base : boardBase[nr];
+    BoardState &state = io ? blockDevice.state : boardState[nr];
     
     switch (addr & 0xFFFF) {
             
@@ -190,18 +298,29 @@ ZorroManager::pokeFastRamDevice(uint32_t addr, uint8_t value)
             return;
             
         case 0x48: // ec_BaseAddress (A23 - A20, 0x--X-0000)
-            fastRamBaseAddr |= (value & 0xF0) << 16;
-            debug("Zorro II card configured (mapped to %X)\n", fastRamBaseAddr);
+            base |= (value & 0xF0) << 16;
+            debug("Zorro II board %d configured (mapped to %X)\n", nr, base);
             
             /* "Note that writing to register 48 actually configures the board for
              *  both Zorro II and Zorro III boards in the Zorro II configuration
              *  block." [HRM 3rd]
              */
-            fastRamConf = 1;
+            state = BOARD_CONFIGURED;
+            if (!io) mem.updateMemSrcTable();
+
+            // I/O boards are only accessible in the auto-config area
+            if (io && (base < 0xE90000 || base > 0xEFFFFF)) {
+                warn("Block device mapped outside the I/O area (%X)\n", base);
+            }
             return;
             
         case 0x4A: // ec_BaseAddress (A19 - A16, 0x---X0000)
-            fastRamBaseAddr = (value & 0xF0) << 12;
+            base = (value & 0xF0) << 12;
+            return;
+
+        case 0x4C: // ec_Shutup
+            debug("Zorro II board %d shut up\n", nr);
+            state = BOARD_SHUTUP;
             return;
             
         default:
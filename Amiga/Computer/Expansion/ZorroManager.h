@@ -11,6 +11,7 @@
 #define _ZORRO_MANAGER_INC
 
 #include "AmigaComponent.h"
+#include "BlockDevice.h"
 
 /* Additional information:
  *
@@ -18,18 +19,39 @@
  *   github.com/PR77/A500_ACCEL_RAM_IDE-Rev-1/blob/master/Logic/RAM/A500_RAM.v
  */
 
-// Manager for plugged in Zorro II devices
+/* Manager for plugged in Zorro II devices
+ *
+ * Up to ZORRO_BOARDS Fast Ram boards can be plugged in. The boards are
+ * configured one after another by Kickstart via the auto-config protocol.
+ * Only the first unconfigured board responds in the auto-config space. Once
+ * Kickstart has assigned a base address (or shut the board up), the next
+ * board becomes visible. The Ram of all boards is stored consecutively in
+ * Memory::fast. When a board gets configured, Memory maps its Ram into the
+ * Zorro II address space (0x200000 - 0x9FFFFF) by updating the bank table.
+ * If an image is attached to the block device, the block device is
+ * configured after all Ram boards.
+ */
 class ZorroManager : public AmigaComponent {
 
+public:
+
+    // Emulated hard drive for fast bulk transfers
+    BlockDevice blockDevice = BlockDevice(amiga);
+
+private:
+
+    // Fast Ram size of each board in bytes (0 = slot is empty)
+    uint32_t boardSize[ZORRO_BOARDS];
+
+    // The current configuration state of each board
+    BoardState boardState[ZORRO_BOARDS];
+
+    // Base address of each board (value is provided by Kickstart)
+    uint32_t boardBase[ZORRO_BOARDS];
+
     // The value returned when peeking into the auto-config space.
     uint8_t autoConfData;
     
-    // The current configuration state (0 = unconfigured).
-    uint8_t fastRamConf;
-    
-    // Base address of the Fast Ram (value is provided by Kickstart).
-    uint32_t fastRamBaseAddr;
-    
     
     //
     // Constructing and destructing
@@ -47,6 +69,9 @@ public:
     template <class T>
     void applyToPersistentItems(T& worker)
     {
+        worker
+
+        & boardSize;
     }
 
     template <class T>
@@ -54,9 +79,9 @@ public:
     {
         worker
 
-        & autoConfData
-        & fastRamConf
-        & fastRamBaseAddr;
+        & boardState
+        & boardBase
+        & autoConfData;
     }
 
 
@@ -78,16 +103,55 @@ private:
 public:
     
     //
-    // Getter and setter
+    // Configuring
     //
-    
-    
+
+    ZorroConfig getConfig();
+
+    /* Plugs in a Fast Ram board of the specified size (0 removes the board)
+     * The size must be a power of two between 64 KB and 8 MB. The total
+     * amount of Fast Ram must not exceed the 8 MB Zorro II address space.
+     */
+    bool setBoardSize(int nr, size_t size);
+
+    // Returns the total amount of Fast Ram of all boards
+    size_t totalSize();
+
+
     //
-    // Emulating Fast Ram
+    // Accessing boards
+    //
+
+    // Returns the size of a board
+    size_t getBoardSize(int nr) { assert(nr < ZORRO_BOARDS); return boardSize[nr]; }
+
+    // Returns the start offset of a board's Ram inside Memory::fast
+    size_t getBoardOffset(int nr);
+
+    // Returns the base address of a board (valid if the board is configured)
+    uint32_t getBoardBase(int nr) { assert(nr < ZORRO_BOARDS); return boardBase[nr]; }
+
+    // Indicates if a board has been mapped into the address space
+    bool isMapped(int nr) { return boardSize[nr] && boardState[nr] == BOARD_CONFIGURED; }
+
+private:
+
+    /* Returns the board that currently responds in the auto-config space
+     * The block device is identified by ZORRO_BOARDS. -1 is returned if all
+     * boards have been configured.
+     */
+    int currentBoard();
+
+
+    //
+    // Emulating the auto-config space
     //
     
-    uint8_t peekFastRamDevice(uint32_t addr);
-    void pokeFastRamDevice(uint32_t addr, uint8_t value);
+public:
+
+    uint8_t peekAutoConf(uint32_t addr);
+    uint8_t spypeekAutoConf(uint32_t addr);
+    void pokeAutoConf(uint32_t addr, uint8_t value);
 };
 
 #endif
@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+// This file must conform to standard ANSI-C to be compatible with Swift.
+
+#ifndef _ZORRO_T_INC
+#define _ZORRO_T_INC
+
+// Maximum number of Zorro II expansion boards
+#define ZORRO_BOARDS 4
+
+//
+// Enumerations
+//
+
+typedef enum : long
+{
+    BOARD_UNCONFIGURED,
+    BOARD_CONFIGURED,
+    BOARD_SHUTUP
+}
+BoardState;
+
+inline bool isBoardState(long value)
+{
+    return value >= BOARD_UNCONFIGURED && value <= BOARD_SHUTUP;
+}
+
+inline bool isValidBoardSize(long bytes)
+{
+    // Zorro II Ram boards range from 64 KB to 8 MB (powers of two only)
+    return bytes == 0 || (bytes >= 0x10000 && bytes <= 0x800000 && !(bytes & (bytes - 1)));
+}
+
+//
+// Structures
+//
+
+typedef struct
+{
+    // Fast Ram size of each board in bytes (0 = slot is empty)
+    size_t boardSize[ZORRO_BOARDS];
+}
+ZorroConfig;
+
+#endif
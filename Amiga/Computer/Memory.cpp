@@ -16,6 +16,7 @@ Memory::Memory(Amiga& ref) : AmigaComponent(ref)
 
     memset(&config, 0, sizeof(config));
     config.extStart = 0xE0;
+    memset(fastBank, 0, sizeof(fastBank));
 }
 
 Memory::~Memory()
@@ -23,15 +24,110 @@ Memory::~Memory()
     dealloc();
 }
 
+/* Returns the number of bytes allocated for a memory area
+ * We allocate three bytes more than we need to handle the case that a long
+ * word access is performed on the last memory address. RAM is allocated in
+ * whole pages which enables copy-on-write cloning.
+ */
+static size_t
+pageCapacity(size_t bytes)
+{
+    size_t pageSize = (size_t)getpagesize();
+    return (bytes + 3 + pageSize - 1) & ~(pageSize - 1);
+}
+
+// Allocates zero-initialized pages
+static uint8_t *
+allocPages(size_t bytes)
+{
+    void *addr = mmap(NULL, pageCapacity(bytes), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON, -1, 0);
+
+    return addr == MAP_FAILED ? NULL : (uint8_t *)addr;
+}
+
+// Frees pages allocated with allocPages()
+static void
+freePages(uint8_t *ptr, size_t bytes)
+{
+    if (ptr) munmap(ptr, pageCapacity(bytes));
+}
+
+// Copies pages allocated with allocPages() (copy-on-write if possible)
+static void
+copyPages(uint8_t *dst, const uint8_t *src, size_t bytes)
+{
+    size_t capacity = pageCapacity(bytes);
+
+    if (vm_copy(mach_task_self(), (vm_address_t)src, capacity, (vm_address_t)dst) != KERN_SUCCESS) {
+        memcpy(dst, src, capacity);
+    }
+}
+
 void
 Memory::dealloc()
 {
-    if (rom) { delete[] rom; rom = NULL; }
-    if (wom) { delete[] wom; wom = NULL; }
-    if (ext) { delete[] ext; ext = NULL; }
-    if (chip) { delete[] chip; chip = NULL; }
-    if (slow) { delete[] slow; slow = NULL; }
-    if (fast) { delete[] fast; fast = NULL; }
+    if (rom) { romImage = NULL; rom = NULL; }
+    if (wom) { freePages(wom, config.womSize); wom = NULL; }
+    if (ext) { extImage = NULL; ext = NULL; }
+    if (chip) { freePages(chip, config.chipSize); chip = NULL; }
+    if (slow) { freePages(slow, config.slowSize); slow = NULL; }
+    if (fast) { freePages(fast, config.fastSize); fast = NULL; }
+}
+
+void
+Memory::cloneRoms(Memory &other)
+{
+    romImage = other.romImage;
+    rom = other.rom;
+    romMask = other.romMask;
+    config.romSize = other.config.romSize;
+
+    extImage = other.extImage;
+    ext = other.ext;
+    extMask = other.extMask;
+    config.extSize = other.config.extSize;
+    config.extStart = other.config.extStart;
+
+    updateMemSrcTable();
+}
+
+bool
+Memory::cloneRam(Memory &other)
+{
+    uint8_t **dst[4] = { &wom, &chip, &slow, &fast };
+    uint8_t *src[4] = { other.wom, other.chip, other.slow, other.fast };
+    size_t *size[4] = { &config.womSize, &config.chipSize, &config.slowSize, &config.fastSize };
+    size_t otherSize[4] = {
+        other.config.womSize, other.config.chipSize,
+        other.config.slowSize, other.config.fastSize };
+
+    for (int i = 0; i < 4; i++) {
+
+        // Reallocate if the size differs
+        if (*size[i] != otherSize[i]) {
+
+            freePages(*dst[i], *size[i]);
+            *dst[i] = otherSize[i] ? allocPages(otherSize[i]) : NULL;
+            *size[i] = otherSize[i];
+
+            if (otherSize[i] && *dst[i] == NULL) {
+                warn("Cannot allocate %d KB of memory\n", otherSize[i] >> 10);
+                *size[i] = 0;
+                return false;
+            }
+        }
+
+        if (src[i]) copyPages(*dst[i], src[i], otherSize[i]);
+    }
+
+    womMask = other.womMask;
+    chipMask = other.chipMask;
+    slowMask = other.slowMask;
+    fastMask = other.fastMask;
+
+    updateMemSrcTable();
+    return true;
 }
 
 void
@@ -111,12 +207,21 @@ Memory::_size()
     applyToPersistentItems(counter);
     applyToResetItems(counter);
 
-    counter.count += sizeof(config.romSize) + config.romSize;
-    counter.count += sizeof(config.womSize) + config.womSize;
-    counter.count += sizeof(config.extSize) + config.extSize;
-    counter.count += sizeof(config.chipSize) + config.chipSize;
-    counter.count += sizeof(config.slowSize) + config.slowSize;
-    counter.count += sizeof(config.fastSize) + config.fastSize;
+    counter.count += sizeof(config.romSize);
+    counter.count += sizeof(config.womSize);
+    counter.count += sizeof(config.extSize);
+    counter.count += sizeof(config.chipSize);
+    counter.count += sizeof(config.slowSize);
+    counter.count += sizeof(config.fastSize);
+
+    if (serializeContents) {
+        counter.count += config.romSize;
+        counter.count += config.womSize;
+        counter.count += config.extSize;
+        counter.count += config.chipSize;
+        counter.count += config.slowSize;
+        counter.count += config.fastSize;
+    }
 
     return counter.count;
 }
@@ -125,15 +230,23 @@ size_t
 Memory::didLoadFromBuffer(uint8_t *buffer)
 {
     SerReader reader(buffer);
+    MemoryConfig newConfig = config;
 
     // Load memory size information
     reader
-    & config.romSize
-    & config.womSize
-    & config.extSize
-    & config.chipSize
-    & config.slowSize
-    & config.fastSize;
+    & newConfig.romSize
+    & newConfig.womSize
+    & newConfig.extSize
+    & newConfig.chipSize
+    & newConfig.slowSize
+    & newConfig.fastSize;
+
+    // The contents are transferred separately if they are not serialized
+    if (!serializeContents) return reader.ptr - buffer;
+
+    // Free previously allocated memory
+    dealloc();
+    config = newConfig;
 
     // Make sure that corrupted values do not cause any damage
     if (config.romSize > KB(512)) { config.romSize = 0; assert(false); }
@@ -143,25 +256,35 @@ Memory::didLoadFromBuffer(uint8_t *buffer)
     if (config.slowSize > KB(512)) { config.slowSize = 0; assert(false); }
     if (config.fastSize > MB(8)) { config.fastSize = 0; assert(false); }
 
-    // Free previously allocated memory
-    dealloc();
-
     // Allocate new memory
-    if (config.romSize) rom = new (std::nothrow) uint8_t[config.romSize + 3];
-    if (config.womSize) wom = new (std::nothrow) uint8_t[config.womSize + 3];
-    if (config.extSize) ext = new (std::nothrow) uint8_t[config.extSize + 3];
-    if (config.chipSize) chip = new (std::nothrow) uint8_t[config.chipSize + 3];
-    if (config.slowSize) slow = new (std::nothrow) uint8_t[config.slowSize + 3];
-    if (config.fastSize) fast = new (std::nothrow) uint8_t[config.fastSize + 3];
+    if (config.womSize) wom = allocPages(config.womSize);
+    if (config.chipSize) chip = allocPages(config.chipSize);
+    if (config.slowSize) slow = allocPages(config.slowSize);
+    if (config.fastSize) fast = allocPages(config.fastSize);
+
+    // Get the Roms from the Rom cache
+    if (config.romSize) {
+        romImage = RomCache::acquire(reader.ptr, config.romSize);
+        rom = romImage ? romImage->data : NULL;
+    }
+    reader.ptr += config.romSize;
 
     // Load memory contents from buffer
-    reader.copy(rom, config.romSize);
     reader.copy(wom, config.womSize);
-    reader.copy(ext, config.extSize);
+
+    if (config.extSize) {
+        extImage = RomCache::acquire(reader.ptr, config.extSize);
+        ext = extImage ? extImage->data : NULL;
+    }
+    reader.ptr += config.extSize;
+
     reader.copy(chip, config.chipSize);
     reader.copy(slow, config.slowSize);
     reader.copy(fast, config.fastSize);
 
+    // Map the Fast Ram of all configured boards
+    updateMemSrcTable();
+
     return reader.ptr - buffer;
 }
 
@@ -178,6 +301,8 @@ Memory::didSaveToBuffer(uint8_t *buffer)
     & config.slowSize
     & config.fastSize;
 
+    if (!serializeContents) return writer.ptr - buffer;
+
     // Save memory contents
     writer.copy(rom, config.romSize);
     writer.copy(wom, config.womSize);
@@ -201,28 +326,68 @@ Memory::alloc(size_t bytes, uint8_t *&ptr, size_t &size, uint32_t &mask)
     if (bytes == size) return true;
     
     // Delete previous allocation
-    if (ptr) { delete[] ptr; ptr = NULL; size = 0; mask = 0; }
+    if (ptr) { freePages(ptr, size); ptr = NULL; size = 0; mask = 0; }
     
-    // Allocate memory
+    // Allocate memory (the pages are zero-initialized)
     if (bytes) {
         
-        // We allocate three bytes more than we need to handle the case
-        // that a long word access is performed on the last memory address.
-        size_t allocSize = bytes + 3;
-        
-        if (!(ptr = new (std::nothrow) uint8_t[allocSize])) {
+        if (!(ptr = allocPages(bytes))) {
             warn("Cannot allocate %d KB of memory\n", bytes);
             return false;
         }
         size = bytes;
         mask = bytes - 1;
-        memset(ptr, 0, allocSize);
+    }
+
+    updateMemSrcTable();
+    return true;
+}
+
+bool
+Memory::install(const uint8_t *buffer, size_t length, std::shared_ptr<RomImage> &image,
+                uint8_t *&ptr, size_t &size, uint32_t &mask)
+{
+    // Release the old image
+    image = NULL;
+    ptr = NULL;
+    size = 0;
+    mask = 0;
+
+    // Get the new image from the cache
+    if (buffer && length) {
+
+        if (!(image = RomCache::acquire(buffer, length))) {
+            warn("Cannot allocate %d KB of memory\n", length);
+            updateMemSrcTable();
+            return false;
+        }
+        ptr = image->data;
+        size = length;
+        mask = length - 1;
     }
 
     updateMemSrcTable();
     return true;
 }
 
+void
+Memory::eraseRom()
+{
+    assert(rom);
+
+    vector<uint8_t> zeroes(config.romSize);
+    installRom(zeroes.data(), zeroes.size());
+}
+
+void
+Memory::eraseExt()
+{
+    assert(ext);
+
+    vector<uint8_t> zeroes(config.extSize);
+    installExt(zeroes.data(), zeroes.size());
+}
+
 void
 Memory::fillRamWithStartupPattern()
 {
@@ -495,9 +660,8 @@ Memory::loadRom(RomFile *file)
 {
     assert(file != NULL);
 
-    // Allocate memory and load file
-    if (!allocRom(file->getSize())) return false;
-    loadRom(file, rom, config.romSize);
+    // Install the Rom image
+    if (!installRomFile(file, false)) return false;
 
     // Add a Wom if a Boot Rom is installed instead of a Kickstart Rom
     hasBootRom() ? (void)allocWom(KB(256)) : deleteWom();
@@ -543,9 +707,8 @@ Memory::loadExt(ExtFile *file)
 {
     assert(file != NULL);
 
-    // Allocate memory and load file
-    if (!allocExt(file->getSize())) return false;
-    loadRom(file, ext, config.extSize);
+    // Install the Rom image
+    if (!installRomFile(file, true)) return false;
 
     return true;
 }
@@ -584,21 +747,18 @@ Memory::loadExtFromFile(const char *path)
     return loadExt(file);
 }
 
-void
-Memory::loadRom(AmigaFile *file, uint8_t *target, size_t length)
+bool
+Memory::installRomFile(AmigaFile *file, bool ext)
 {
-    if (file) {
-
-        assert(target != NULL);
-        memset(target, 0, length);
+    assert(file != NULL);
 
-        file->seek(0);
+    vector<uint8_t> buffer(file->getSize());
+    file->flash(buffer.data());
 
-        int c;
-        for (size_t i = 0; i < length; i++) {
-            if ((c = file->read()) == EOF) break;
-            *(target++) = c;
-        }
+    if (ext) {
+        return installExt(buffer.data(), buffer.size());
+    } else {
+        return installRom(buffer.data(), buffer.size());
     }
 }
 
@@ -610,7 +770,6 @@ Memory::updateMemSrcTable()
 
     int chipRamPages = hasChipRam() ? 32 : 0;
     int slowRamPages = config.slowSize / 0x10000;
-    int fastRamPages = config.fastSize / 0x10000;
     int extRomPages  = hasExt() ? 8 : 0;
 
     // Mirror Chip Ram if only a 256KB Rom is present
@@ -630,9 +789,26 @@ Memory::updateMemSrcTable()
     for (unsigned i = 0; i < chipRamPages; i++)
         memSrc[i] = MEM_CHIP;
     
-    // Fast Ram
-    for (unsigned i = 0; i < fastRamPages; i++)
-        memSrc[0x20 + i] = MEM_FAST;
+    // Fast Ram (only the boards that have been configured by Kickstart)
+    memset(fastBank, 0, sizeof(fastBank));
+    for (int nr = 0; nr < ZORRO_BOARDS; nr++) {
+
+        if (!zorro.isMapped(nr)) continue;
+
+        size_t offset = zorro.getBoardOffset(nr);
+        unsigned first = zorro.getBoardBase(nr) >> 16;
+        unsigned banks = zorro.getBoardSize(nr) / 0x10000;
+        if (offset + zorro.getBoardSize(nr) > config.fastSize) continue;
+
+        for (unsigned i = 0; i < banks; i++) {
+
+            // Stay inside the Zorro II address space
+            if (first + i < 0x20 || first + i > 0x9F) continue;
+
+            memSrc[first + i] = MEM_FAST;
+            fastBank[first + i] = fast + offset + i * 0x10000;
+        }
+    }
 
     // CIA range
     for (unsigned i = 0xA0; i <= 0xBF; i++)
@@ -685,6 +861,19 @@ Memory::updateMemSrcTable()
     amiga.putMessage(MSG_MEM_LAYOUT);
 }
 
+uint8_t *
+Memory::ramPtr(uint32_t addr)
+{
+    switch (memSrc[(addr >> 16) & 0xFF]) {
+
+        case MEM_CHIP: return chip + (addr & chipMask);
+        case MEM_SLOW: return slow + (addr & slowMask);
+        case MEM_FAST: return fastBank[(addr >> 16) & 0xFF] + (addr & 0xFFFF);
+
+        default: return NULL;
+    }
+}
+
 uint8_t
 Memory::peek8(uint32_t addr)
 {
@@ -1982,10 +2171,20 @@ Memory::pokeCustom32(uint32_t addr, uint32_t value)
     pokeCustom16<POKE_CPU>(addr + 2, LO_WORD(value));
 }
 
+bool
+Memory::isBlockDeviceAddr(uint32_t addr)
+{
+    BlockDevice &device = zorro.blockDevice;
+    return device.isMapped() && ((addr ^ device.getBase()) & 0xFF0000) == 0;
+}
+
 uint8_t
 Memory::peekAutoConf8(uint32_t addr)
 {
-    uint8_t result = zorro.peekFastRamDevice(addr) << 4;
+    // Zorro II I/O space
+    if (isBlockDeviceAddr(addr)) return zorro.blockDevice.peek8(addr);
+
+    uint8_t result = zorro.peekAutoConf(addr) << 4;
     
     // debug("peekAutoConf8(%X) = %X\n", addr, result);
     return result;
@@ -2000,19 +2199,38 @@ Memory::peekAutoConf16(uint32_t addr)
     return result;
 }
 
+uint8_t
+Memory::spypeekAutoConf8(uint32_t addr)
+{
+    // Zorro II I/O space
+    if (isBlockDeviceAddr(addr)) return zorro.blockDevice.peek8(addr);
+
+    return zorro.spypeekAutoConf(addr) << 4;
+}
+
+uint16_t
+Memory::spypeekAutoConf16(uint32_t addr)
+{
+    return HI_LO(spypeekAutoConf8(addr), spypeekAutoConf8(addr + 1));
+}
+
 void
 Memory::pokeAutoConf8(uint32_t addr, uint8_t value)
 {
     // debug("pokeAutoConf8(%X, %X)\n", addr, value);
-    zorro.pokeFastRamDevice(addr, value);
+
+    // Zorro II I/O space
+    if (isBlockDeviceAddr(addr)) { zorro.blockDevice.poke8(addr, value); return; }
+
+    zorro.pokeAutoConf(addr, value);
 }
 
 void
 Memory::pokeAutoConf16(uint32_t addr, uint16_t value)
 {
     // debug("pokeAutoConf16(%X, %X)\n", addr, value);
-    zorro.pokeFastRamDevice(addr, HI_BYTE(value));
-    zorro.pokeFastRamDevice(addr + 1, LO_BYTE(value));
+    pokeAutoConf8(addr, HI_BYTE(value));
+    pokeAutoConf8(addr + 1, LO_BYTE(value));
 }
 
 void
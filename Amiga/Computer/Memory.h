@@ -13,6 +13,7 @@
 #include "AmigaComponent.h"
 #include "RomFile.h"
 #include "ExtFile.h"
+#include "RomCache.h"
 
 const uint32_t FAST_RAM_STRT = 0x200000; // DEPRECATED
 const uint32_t SLOW_RAM_MASK = 0x07FFFF; // DEPRECATED
@@ -20,7 +21,7 @@ const uint32_t EXT_ROM_MASK  = 0x07FFFF; // DEPRECATED
 
 // Verifies the range of an address
 #define ASSERT_CHIP_ADDR(x) assert(chip != NULL); assert(((x) % config.chipSize) == ((x) & chipMask));
-#define ASSERT_FAST_ADDR(x) assert(fast != NULL); assert(((x) - FAST_RAM_STRT) < config.fastSize);
+#define ASSERT_FAST_ADDR(x) assert(fastBank[((x) >> 16) & 0xFF] != NULL);
 #define ASSERT_SLOW_ADDR(x) assert(slow != NULL); assert(((x) & SLOW_RAM_MASK) < config.slowSize); assert(((x) & SLOW_RAM_MASK) == (x & slowMask));
 #define ASSERT_ROM_ADDR(x) assert(rom != NULL); assert(((x) % config.romSize) == ((x) & romMask));
 #define ASSERT_WOM_ADDR(x) assert(wom != NULL); assert(((x) % config.womSize) == ((x) & womMask));
@@ -41,9 +42,9 @@ const uint32_t EXT_ROM_MASK  = 0x07FFFF; // DEPRECATED
 #define READ_CHIP_32(x) READ_32(chip + ((x) & chipMask))
 
 // Reads a value from Fast RAM in big endian format
-#define READ_FAST_8(x)  READ_8 (fast + ((x) - FAST_RAM_STRT))
-#define READ_FAST_16(x) READ_16(fast + ((x) - FAST_RAM_STRT))
-#define READ_FAST_32(x) READ_32(fast + ((x) - FAST_RAM_STRT))
+#define READ_FAST_8(x)  READ_8 (fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF))
+#define READ_FAST_16(x) READ_16(fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF))
+#define READ_FAST_32(x) READ_32(fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF))
 
 // Reads a value from Slow RAM in big endian format
 #define READ_SLOW_8(x)  READ_8 (slow + ((x) & slowMask))
@@ -76,9 +77,9 @@ const uint32_t EXT_ROM_MASK  = 0x07FFFF; // DEPRECATED
 #define WRITE_CHIP_32(x,y) WRITE_32(chip + ((x) & chipMask), (y))
 
 // Writes a value into Fast RAM in big endian format
-#define WRITE_FAST_8(x,y)  WRITE_8 (fast + ((x) - FAST_RAM_STRT), (y))
-#define WRITE_FAST_16(x,y) WRITE_16(fast + ((x) - FAST_RAM_STRT), (y))
-#define WRITE_FAST_32(x,y) WRITE_32(fast + ((x) - FAST_RAM_STRT), (y))
+#define WRITE_FAST_8(x,y)  WRITE_8 (fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF), (y))
+#define WRITE_FAST_16(x,y) WRITE_16(fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF), (y))
+#define WRITE_FAST_32(x,y) WRITE_32(fastBank[((x) >> 16) & 0xFF] + ((x) & 0xFFFF), (y))
 
 // Writes a value into Slow RAM in big endian format
 #define WRITE_SLOW_8(x,y)  WRITE_8 (slow + ((x) & slowMask), (y))
@@ -151,6 +152,9 @@ public:
      *    pointer == NULL <=> config.size == 0 <=> mask == 0
      *    pointer != NULL <=> mask == config.size - 1
      *
+     * The Roms are not allocated by this class. They are shared read-only
+     * images managed by the RomCache. Hence, emulator instances running the
+     * same Kickstart share the same memory.
      */
     uint8_t *rom = NULL;
     uint8_t *wom = NULL;
@@ -159,6 +163,10 @@ public:
     uint8_t *slow = NULL;
     uint8_t *fast = NULL;
 
+    // The Rom images rom and ext are pointing into
+    std::shared_ptr<RomImage> romImage;
+    std::shared_ptr<RomImage> extImage;
+
     uint32_t romMask = 0;
     uint32_t womMask = 0;
     uint32_t extMask = 0;
@@ -182,11 +190,25 @@ public:
      */
     MemorySource memSrc[256];
 
+    /* Host address of each Fast Ram bank
+     * Fast Ram is provided by Zorro II boards which can be mapped to
+     * different base addresses. For each bank that is mapped to MEM_FAST,
+     * this table points to the corresponding 64KB chunk inside 'fast'.
+     * See also: updateMemSrcTable()
+     */
+    uint8_t *fastBank[256];
+
     // The last value on the data bus
     uint16_t dataBus;
 
     // Buffer for returning string values
     char str[256];
+
+    /* Indicates if the memory contents are part of a snapshot
+     * This flag is cleared temporarily by Amiga::clone() which transfers the
+     * memory contents separately.
+     */
+    bool serializeContents = true;
     
 
     //
@@ -231,6 +253,12 @@ public:
     // Frees the allocated memory
     void dealloc();
 
+    // Shares the Rom images of another instance
+    void cloneRoms(Memory &other);
+
+    // Duplicates the Ram contents of another instance (copy-on-write)
+    bool cloneRam(Memory &other);
+
     // Returns the current configuration
     MemoryConfig getConfig() { return config; }
 
@@ -292,13 +320,26 @@ public:
     void deleteSlow() { allocSlow(0); }
     void deleteFast() { allocFast(0); }
 
-    bool allocRom(size_t bytes) { return alloc(bytes, rom, config.romSize, romMask); }
     bool allocWom(size_t bytes) { return alloc(bytes, wom, config.womSize, womMask); }
-    bool allocExt(size_t bytes) { return alloc(bytes, ext, config.extSize, extMask); }
 
-    void deleteRom() { allocRom(0); }
+    void deleteRom() { installRom(NULL, 0); }
     void deleteWom() { allocWom(0); }
-    void deleteExt() { allocExt(0); }
+    void deleteExt() { installExt(NULL, 0); }
+
+private:
+
+    /* Installs a shared Rom image with the specified contents
+     * Passing a NULL pointer removes the currently installed image.
+     */
+    bool install(const uint8_t *buffer, size_t length, std::shared_ptr<RomImage> &image,
+                 uint8_t *&ptr, size_t &size, uint32_t &mask);
+
+public:
+
+    bool installRom(const uint8_t *buffer, size_t length) {
+        return install(buffer, length, romImage, rom, config.romSize, romMask); }
+    bool installExt(const uint8_t *buffer, size_t length) {
+        return install(buffer, length, extImage, ext, config.extSize, extMask); }
 
 
     //
@@ -321,14 +362,14 @@ public:
 
 public:
 
-    // Computes a CRC-32 checksum
-    uint32_t romFingerprint() { return crc32(rom, config.romSize); }
-    uint32_t extFingerprint() { return crc32(ext, config.extSize); }
+    // Returns the CRC-32 checksum (computed once by the Rom cache)
+    uint32_t romFingerprint() { return romImage ? romImage->fingerprint : 0; }
+    uint32_t extFingerprint() { return extImage ? extImage->fingerprint : 0; }
 
     // Translates a CRC-32 checksum into a ROM identifier
     static RomRevision revision(uint32_t fingerprint);
-    RomRevision romRevision() { return revision(romFingerprint()); }
-    RomRevision extRevision() { return revision(extFingerprint()); }
+    RomRevision romRevision() { return romImage ? romImage->revision : ROM_MISSING; }
+    RomRevision extRevision() { return extImage ? extImage->revision : ROM_MISSING; }
 
     // Analyzes a ROM identifier by type
     static bool isBootRom(RomRevision rev);
@@ -359,9 +400,9 @@ public:
     bool hasExt() { return ext != NULL; }
 
     // Erases an installed ROM
-    void eraseRom() { assert(rom); memset(rom, 0, config.romSize); }
+    void eraseRom();
     void eraseWom() { assert(wom); memset(wom, 0, config.womSize); }
-    void eraseExt() { assert(ext); memset(ext, 0, config.extSize); }
+    void eraseExt();
 
     // Installs a new Boot Rom or Kickstart Rom
     bool loadRom(RomFile *rom);
@@ -374,8 +415,8 @@ public:
 
 private:
 
-    // Loads Rom data from a file.
-    void loadRom(AmigaFile *rom, uint8_t *target, size_t length);
+    // Installs the contents of a Rom file as a shared Rom image
+    bool installRomFile(AmigaFile *file, bool ext);
 
     
     //
@@ -392,6 +433,12 @@ public:
     
     // Updates the memory source lookup table.
     void updateMemSrcTable();
+
+    /* Returns a host pointer to the Ram cell at the specified address
+     * NULL is returned if no Chip, Slow, or Fast Ram is mapped at this
+     * address. Ram is contiguous on the host within each 64 KB bank.
+     */
+    uint8_t *ramPtr(uint32_t addr);
     
     
     //
@@ -500,11 +547,14 @@ public:
     // Auto-config space (Zorro II)
     //
     
+    // Checks if an address belongs to the I/O space of the block device
+    bool isBlockDeviceAddr(uint32_t addr);
+
     uint8_t peekAutoConf8(uint32_t addr);
     uint16_t peekAutoConf16(uint32_t addr);
     
-    uint8_t spypeekAutoConf8(uint32_t addr) { return peekAutoConf8(addr); }
-    uint16_t spypeekAutoConf16(uint32_t addr) { return peekAutoConf16(addr); }
+    uint8_t spypeekAutoConf8(uint32_t addr);
+    uint16_t spypeekAutoConf16(uint32_t addr);
     
     void pokeAutoConf8(uint32_t addr, uint8_t value);
     void pokeAutoConf16(uint32_t addr, uint16_t value);
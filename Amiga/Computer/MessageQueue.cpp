@@ -13,10 +13,43 @@ MessageQueue::MessageQueue()
 {
     setDescription("MessageQueue");
 	pthread_mutex_init(&lock, NULL);
+
+    pthread_mutex_init(&wakeLock, NULL);
+    pthread_cond_init(&wakeCond, NULL);
+
+    for (size_t i = 0; i < capacity; i++) queue[i].sequence.store(i);
+    w.store(0);
+    r.store(0);
+
+    // Time stamps are taken in kernel time
+    mach_timebase_info_data_t tb;
+    mach_timebase_info(&tb);
+    maxLatencyTicks = maxLatency * tb.denom / tb.numer;
+
+    sent.store(0);
+    dropped.store(0);
+    delivered.store(0);
+    delayed.store(0);
+    batches.store(0);
+
+    // Launch the delivery thread
+    hasListeners.store(false);
+    idle.store(false);
+    terminate.store(false);
+    pthread_create(&deliveryThread, NULL, deliveryMain, (void *)this);
 }
 
 MessageQueue::~MessageQueue()
 {
+    // Stop the delivery thread
+    pthread_mutex_lock(&wakeLock);
+    terminate.store(true);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&wakeLock);
+    pthread_join(deliveryThread, NULL);
+
+    pthread_cond_destroy(&wakeCond);
+    pthread_mutex_destroy(&wakeLock);
 	pthread_mutex_destroy(&lock);
 }
 
@@ -25,13 +58,16 @@ MessageQueue::addListener(const void *listener, Callback *func)
 {
     pthread_mutex_lock(&lock);
     listeners.insert(pair <const void *, Callback *> (listener, func));
+    hasListeners.store(true);
     pthread_mutex_unlock(&lock);
     
     // Distribute all pending messages
-    Message msg;
-    while ((msg = getMessage()).type != MSG_NONE) {
-        propagateMessage(&msg);
-    }
+    deliverMessages();
+    
+    // Let the delivery thread take over
+    pthread_mutex_lock(&wakeLock);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&wakeLock);
 }
 
 void
@@ -39,6 +75,7 @@ MessageQueue::removeListener(const void *listener)
 {
     pthread_mutex_lock(&lock);
     listeners.erase(listener);
+    hasListeners.store(!listeners.empty());
     pthread_mutex_unlock(&lock);
 }
 
@@ -46,16 +83,14 @@ Message
 MessageQueue::getMessage()
 { 
 	Message result;
+    uint64_t stamp;
 
 	pthread_mutex_lock(&lock);	
 
 	// Read message
-	if (r == w) {
+	if (!dequeue(result, stamp)) {
 		result.type = MSG_NONE; // Queue is empty
         result.data = 0;
-	} else {
-        result = queue[r];
-        r = (r + 1) % capacity;
 	}
 		
 	pthread_mutex_unlock(&lock);
@@ -66,26 +101,165 @@ MessageQueue::getMessage()
 void
 MessageQueue::putMessage(MessageType type, uint64_t data)
 {
-	pthread_mutex_lock(&lock);
-		
-	// Write data
-    Message msg;
-    msg.type = type;
-    msg.data = data;
-    queue[w] = msg;
-    
-	// Move write pointer to next location
-	w = (w + 1) % capacity;
+    uint64_t pos = w.load(std::memory_order_relaxed);
+    Slot *slot;
 
-	if (w == r) {
-        // debug(2, "Queue overflow. Oldest message is lost.\n");
-		r = (r + 1) % capacity;
-	}
-    
-    // Serve registered callbacks
-    propagateMessage(&msg);
+    // Reserve a slot
+    while (1) {
 
-	pthread_mutex_unlock(&lock);
+        slot = &queue[pos & (capacity - 1)];
+        uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+
+        if (diff == 0) {
+
+            // The slot is free. Try to claim it
+            if (w.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+
+        } else if (diff < 0) {
+
+            // The queue is full
+            debug(2, "Queue overflow. Message %d is lost.\n", type);
+            dropped++;
+            return;
+
+        } else {
+
+            // Another producer has claimed the slot in the meantime
+            pos = w.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Write data
+    slot->message.type = type;
+    slot->message.data = data;
+    slot->stamp = mach_absolute_time();
+
+    // Publish the slot
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    sent++;
+
+    // Wake up the delivery thread if it is waiting for messages
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle.load() && hasListeners.load()) wakeUp();
+}
+
+MessageQueueStats
+MessageQueue::getStats()
+{
+    MessageQueueStats result;
+
+    result.sent = sent.load();
+    result.dropped = dropped.load();
+    result.delivered = delivered.load();
+    result.delayed = delayed.load();
+    result.batches = batches.load();
+
+    return result;
+}
+
+bool
+MessageQueue::pending()
+{
+    uint64_t pos = r.load(std::memory_order_relaxed);
+    Slot *slot = &queue[pos & (capacity - 1)];
+
+    return slot->sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+bool
+MessageQueue::dequeue(Message &msg, uint64_t &stamp)
+{
+    uint64_t pos = r.load(std::memory_order_relaxed);
+    Slot *slot = &queue[pos & (capacity - 1)];
+
+    // Check if the slot has been published
+    if (slot->sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+    msg = slot->message;
+    stamp = slot->stamp;
+
+    // Hand the slot back to the producers
+    slot->sequence.store(pos + capacity, std::memory_order_release);
+    r.store(pos + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void
+MessageQueue::deliverMessages()
+{
+    Message batch[batchSize];
+    uint64_t stamp;
+
+    pthread_mutex_lock(&lock);
+
+    // Messages stay in the queue until a listener is registered
+    while (!listeners.empty()) {
+
+        // Collect the next batch
+        size_t count = 0;
+        uint64_t now = mach_absolute_time();
+
+        while (count < batchSize && dequeue(batch[count], stamp)) {
+            if (now > stamp && now - stamp > maxLatencyTicks) delayed++;
+            count++;
+        }
+        if (count == 0) break;
+
+        // Deliver the batch
+        for (size_t i = 0; i < count; i++) propagateMessage(&batch[i]);
+
+        delivered += count;
+        batches++;
+    }
+
+    pthread_mutex_unlock(&lock);
+}
+
+void
+MessageQueue::wakeUp()
+{
+    pthread_mutex_lock(&wakeLock);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&wakeLock);
+}
+
+void *
+MessageQueue::deliveryMain(void *queue)
+{
+    ((MessageQueue *)queue)->deliveryLoop();
+    return NULL;
+}
+
+void
+MessageQueue::deliveryLoop()
+{
+    bool quit = false;
+
+    while (!quit) {
+
+        pthread_mutex_lock(&wakeLock);
+
+        /* Announce that we are about to sleep before checking for messages.
+         * A producer either sees the flag and signals the condition, or we
+         * see the published message.
+         */
+        idle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while (!terminate.load() && !(hasListeners.load() && pending())) {
+            pthread_cond_wait(&wakeCond, &wakeLock);
+        }
+
+        idle.store(false);
+        quit = terminate.load();
+
+        pthread_mutex_unlock(&wakeLock);
+
+        // Deliver all pending messages (including what's left on termination)
+        deliverMessages();
+    }
 }
 
 void
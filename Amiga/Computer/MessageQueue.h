@@ -11,27 +11,93 @@
 #define _MESSAGE_QUEUE_INC
 
 #include "AmigaObject.h"
+#include <atomic>
 
+/* Message queue connecting the emulator with the GUI
+ *
+ * The queue accepts messages from multiple threads (the emulator thread and
+ * the GUI thread) without taking any locks. Each slot carries a sequence
+ * number which tells the producers if the slot is free and the consumer if
+ * the slot has been written completely.
+ *
+ * Messages are delivered by a separate thread which sleeps until a message
+ * arrives, drains the queue, and passes all pending messages to the
+ * registered listeners in batches. If no listener is registered, the thread
+ * stays asleep and messages stay in the queue where they can be read via
+ * getMessage(). If the queue is full, new messages are dropped and counted.
+ * Unlike the old locking queue, the oldest message is kept, because a
+ * producer cannot take a slot back from the consumer without a lock.
+ */
 class MessageQueue : public AmigaObject {
     
 private:
     
-    // Maximum number of queued messages
-    const static size_t capacity = 64;
+    // Maximum number of queued messages (must be a power of 2)
+    const static size_t capacity = 1024;
+    
+    // Maximum number of messages delivered in one batch
+    const static size_t batchSize = 64;
+    
+    // Messages delivered later than this (in nanoseconds) are counted as delayed
+    const static uint64_t maxLatency = 50000000;
+    
+    // maxLatency converted to mach_absolute_time() ticks
+    uint64_t maxLatencyTicks;
+    
+    // Ring buffer element
+    struct Slot {
+        
+        // Sequence number (slot i is free for write number i + k * capacity)
+        std::atomic<uint64_t> sequence;
+        
+        // The stored message
+        Message message;
+        
+        // Time stamp of the write operation
+        uint64_t stamp;
+    };
     
     // Ring buffer storing all pending messages
-    Message queue[capacity];
+    Slot queue[capacity];
+    
+    // Total number of reserved write slots (shared by all producers)
+    std::atomic<uint64_t> w;
     
-    // The ring buffer's read and write pointers
-    int r = 0;
-    int w = 0;
+    // Total number of read messages (written by the consumer side, only)
+    std::atomic<uint64_t> r;
     
-    // Mutex for controlling parallel reads and writes
+    // Statistics
+    std::atomic<long> sent;
+    std::atomic<long> dropped;
+    std::atomic<long> delivered;
+    std::atomic<long> delayed;
+    std::atomic<long> batches;
+    
+    /* Mutex for serializing all consumer side operations
+     * The mutex is never taken by putMessage().
+     */
     pthread_mutex_t lock;
     
     // List of all registered listeners
     map <const void *, Callback *> listeners;
     
+    // Indicates if the listener list is not empty
+    std::atomic<bool> hasListeners;
+    
+    // The delivery thread
+    pthread_t deliveryThread;
+    
+    /* Mutex and condition variable the delivery thread sleeps on
+     * Producers only take the mutex if the thread is idle, i.e., if it is
+     * waiting or about to wait for new messages.
+     */
+    pthread_mutex_t wakeLock;
+    pthread_cond_t wakeCond;
+    std::atomic<bool> idle;
+    
+    // Set to stop the delivery thread
+    std::atomic<bool> terminate;
+    
 public:
     
     // Constructor and destructor
@@ -47,13 +113,37 @@ public:
     // Returns the next pending message, or NULL if the queue is empty.
     Message getMessage();
     
-    // Writes a message into the queue and propagates it to all listeners.
+    // Writes a message into the queue (can be called from any thread).
     void putMessage(MessageType type, uint64_t data = 0);
     
+    // Returns the queue statistics
+    MessageQueueStats getStats();
+    
 private:
     
+    /* Reads the next message from the queue
+     * Must be called with the consumer lock held. Returns false if the queue
+     * is empty.
+     */
+    bool dequeue(Message &msg, uint64_t &stamp);
+    
+    // Checks if the next message to read has been published
+    bool pending();
+    
+    /* Delivers all pending messages to the registered listeners
+     * Called by the delivery thread whenever new messages have arrived.
+     */
+    void deliverMessages();
+    
+    // Wakes up the delivery thread
+    void wakeUp();
+    
+    // Entry point and main loop of the delivery thread
+    static void *deliveryMain(void *queue);
+    void deliveryLoop();
+    
     /* Propagates a single message to all registered listeners.
-     * Called by function putMessage(...)
+     * Must be called with the consumer lock held.
      */
     void propagateMessage(Message *msg);
 };
@@ -76,6 +76,13 @@ typedef enum
     MSG_AUTOSNAPSHOT_SAVED,
     MSG_USERSNAPSHOT_LOADED,
     MSG_USERSNAPSHOT_SAVED,
+
+    // Input recorder
+    MSG_REPLAY_END,
+
+    // Automation
+    MSG_SCRIPT_DONE,
+    MSG_SCRIPT_ABORT,
 }
 MessageType;
 
@@ -93,4 +100,24 @@ Message;
 // Callback function signature
 typedef void Callback(const void *, unsigned, long);
 
+// Message queue statistics
+typedef struct
+{
+    // Number of messages written into the queue
+    long sent;
+
+    // Number of messages lost due to a queue overflow
+    long dropped;
+
+    // Number of messages passed to the listeners
+    long delivered;
+
+    // Number of messages delivered later than expected
+    long delayed;
+
+    // Number of delivered message batches
+    long batches;
+}
+MessageQueueStats;
+
 #endif
@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _AUDIO_STREAM_INC
+#define _AUDIO_STREAM_INC
+
+#include <atomic>
+
+/* Interface for components consuming the generated audio data.
+ *
+ * A sink receives all samples produced by the audio unit in blocks of
+ * variable size. The samples have been filtered, but the volume has not been
+ * applied. They are normalized to the range [-1; 1] with 1 corresponding to
+ * a mixed Paula output of 32768. The consume() function is called from the
+ * emulator thread.
+ */
+class AudioSink {
+
+public:
+
+    virtual ~AudioSink() { }
+
+    // Processes a block of stereo samples
+    virtual void consume(const float *left, const float *right, size_t n) = 0;
+};
+
+/* Lock-free stereo sample ringbuffer
+ *
+ * The buffer connects a single producer (the emulator thread) with a single
+ * consumer (usually the audio thread of the host). Both sides move their own
+ * counter, only. The counters are never wrapped, which is why the fill level
+ * can be computed as the difference of both. The producer publishes new
+ * samples with a release store which is paired with an acquire load on the
+ * consumer side and vice versa.
+ *
+ * Because the producer must not modify the read counter, it cannot move the
+ * read position by itself. Instead, it requests the consumer to do so by
+ * calling requestAlignment() or requestDiscard().
+ */
+template <size_t capacity> class AudioStream {
+
+    static_assert((capacity & (capacity - 1)) == 0, "Capacity must be a power of 2");
+
+    // Sample buffers
+    float bufferL[capacity];
+    float bufferR[capacity];
+
+    // Total number of written and read samples
+    std::atomic<uint64_t> writeCount;
+    std::atomic<uint64_t> readCount;
+
+    // Set by the producer to make the consumer realign the read position
+    std::atomic<bool> alignmentFlag;
+
+    // Set by the producer to make the consumer drop all buffered samples
+    std::atomic<bool> discardFlag;
+
+public:
+
+    AudioStream() { clear(); }
+
+    // Deletes all elements (must not be called while the consumer is active)
+    void clear()
+    {
+        memset(bufferL, 0, sizeof(bufferL));
+        memset(bufferR, 0, sizeof(bufferR));
+        writeCount.store(0);
+        readCount.store(0);
+        alignmentFlag.store(false);
+        discardFlag.store(false);
+    }
+
+    // Returns the capacity of this buffer
+    size_t size() const { return capacity; }
+
+    // Returns the number of stored samples
+    size_t count() const
+    {
+        uint64_t r = readCount.load(std::memory_order_acquire);
+        uint64_t w = writeCount.load(std::memory_order_acquire);
+        return (size_t)(w - r);
+    }
+
+    // Returns the number of free slots
+    size_t free() const { return capacity - count(); }
+
+
+    //
+    // Producer side
+    //
+
+    /* Writes a block of samples
+     * Returns the number of written samples which is smaller than n if the
+     * buffer runs full.
+     */
+    size_t write(const float *left, const float *right, size_t n)
+    {
+        uint64_t w = writeCount.load(std::memory_order_relaxed);
+        uint64_t r = readCount.load(std::memory_order_acquire);
+
+        n = MIN(n, capacity - (size_t)(w - r));
+
+        // Copy the samples in up to two chunks
+        size_t pos = w & (capacity - 1);
+        size_t chunk = MIN(n, capacity - pos);
+        memcpy(bufferL + pos, left, chunk * sizeof(float));
+        memcpy(bufferR + pos, right, chunk * sizeof(float));
+        memcpy(bufferL, left + chunk, (n - chunk) * sizeof(float));
+        memcpy(bufferR, right + chunk, (n - chunk) * sizeof(float));
+
+        writeCount.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    // Asks the consumer to realign the read position
+    void requestAlignment() { alignmentFlag.store(true, std::memory_order_release); }
+
+    // Asks the consumer to drop all samples written so far
+    void requestDiscard() { discardFlag.store(true, std::memory_order_release); }
+
+
+    //
+    // Consumer side
+    //
+
+    /* Reads a block of samples
+     * Returns the number of read samples which is smaller than n if the
+     * buffer runs empty.
+     */
+    size_t read(float *left, float *right, size_t n)
+    {
+        uint64_t r = readCount.load(std::memory_order_relaxed);
+        uint64_t w = writeCount.load(std::memory_order_acquire);
+
+        n = MIN(n, (size_t)(w - r));
+
+        // Copy the samples in up to two chunks
+        size_t pos = r & (capacity - 1);
+        size_t chunk = MIN(n, capacity - pos);
+        memcpy(left, bufferL + pos, chunk * sizeof(float));
+        memcpy(right, bufferR + pos, chunk * sizeof(float));
+        memcpy(left + chunk, bufferL, (n - chunk) * sizeof(float));
+        memcpy(right + chunk, bufferR, (n - chunk) * sizeof(float));
+
+        readCount.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    // Drops up to n samples
+    void skip(size_t n)
+    {
+        uint64_t r = readCount.load(std::memory_order_relaxed);
+        uint64_t w = writeCount.load(std::memory_order_acquire);
+
+        readCount.store(r + MIN(n, (size_t)(w - r)), std::memory_order_release);
+    }
+
+    // Checks and clears a pending alignment request
+    bool alignmentRequested()
+    {
+        if (!alignmentFlag.load(std::memory_order_relaxed)) return false;
+        return alignmentFlag.exchange(false, std::memory_order_acq_rel);
+    }
+
+    // Checks and clears a pending discard request
+    bool discardRequested()
+    {
+        if (!discardFlag.load(std::memory_order_relaxed)) return false;
+        return discardFlag.exchange(false, std::memory_order_acq_rel);
+    }
+
+    // Reads a sample without moving the read position (for visualization)
+    float peekL(size_t offset) const
+    {
+        uint64_t r = readCount.load(std::memory_order_relaxed);
+        return bufferL[(r + offset) & (capacity - 1)];
+    }
+    float peekR(size_t offset) const
+    {
+        uint64_t r = readCount.load(std::memory_order_relaxed);
+        return bufferR[(r + offset) & (capacity - 1)];
+    }
+};
+
+#endif
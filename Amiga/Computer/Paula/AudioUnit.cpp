@@ -8,6 +8,7 @@
 // -----------------------------------------------------------------------------
 
 #include "Amiga.h"
+#include <algorithm>
 
 AudioUnit::AudioUnit(Amiga& ref) : AmigaComponent(ref)
 {
@@ -63,6 +64,19 @@ AudioUnit::setFilterType(FilterType type)
     filterR.setFilterType(type);
 }
 
+void
+AudioUnit::setBandLimiting(bool value)
+{
+    debug(AUD_DEBUG, "setBandLimiting(%d)\n", value);
+
+    config.bandLimiting = value;
+
+    // Restart the synthesizers from silence
+    blepL.clear();
+    blepR.clear();
+    memset(channelOutput, 0, sizeof(channelOutput));
+}
+
 void
 AudioUnit::_powerOn()
 {
@@ -71,15 +85,12 @@ AudioUnit::_powerOn()
 void
 AudioUnit::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-
     info.channel[0] = channel0.getInfo();
     info.channel[1] = channel1.getInfo();
     info.channel[2] = channel2.getInfo();
     info.channel[3] = channel3.getInfo();
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -113,6 +124,10 @@ AudioUnit::_reset()
 
     clearRingbuffer();
 
+    blepL.clear();
+    blepR.clear();
+    memset(channelOutput, 0, sizeof(channelOutput));
+
     bufferUnderflows = 0;
     bufferOverflows = 0;
 
@@ -157,53 +172,132 @@ AudioUnit::executeUntil(Cycle targetClock)
 
     while (dmaCycleCounter1 > 0) {
 
-        short left = 0;
-        short right = 0;
+        DMACycle cycles[synthBlockSize];
+        size_t n = 0;
 
-        // Compute number of DMA cycles in the next sampling interval
-        dmaCycleCounter1 -= dmaCyclesPerSample;
-        Cycle toExecute = (Cycle)(dmaCycleCounter2 - dmaCycleCounter1);
-        dmaCycleCounter2 -= toExecute;
+        // Compute the number of DMA cycles in each sampling interval
+        for (; n < synthBlockSize && dmaCycleCounter1 > 0; n++) {
 
-        // Execute the state machines for all four channels
-        if (dmaEnabled) {
+            dmaCycleCounter1 -= dmaCyclesPerSample;
+            cycles[n] = (DMACycle)(dmaCycleCounter2 - dmaCycleCounter1);
+            dmaCycleCounter2 -= cycles[n];
+        }
 
-            // Channel 0 (left)
-            if (GET_BIT(dmaEnabled, 0)) {
-                left += channel0.execute(toExecute);
-            }
+        synthesize(cycles, n);
+    }
+}
 
-            // Channel 1 (right)
-            if (GET_BIT(dmaEnabled, 1)) {
-                right += channel1.execute(toExecute);
-            }
+void
+AudioUnit::synthesize(const DMACycle *cycles, size_t n)
+{
+    int16_t sample[4][synthBlockSize];
+    float left[synthBlockSize];
+    float right[synthBlockSize];
 
-            // Channel 2 (right)
-            if (GET_BIT(dmaEnabled, 2)) {
-                right += channel2.execute(toExecute);
-            }
+    assert(n <= synthBlockSize);
 
-            // Channel 3 (left)
-            if (GET_BIT(dmaEnabled, 3)) {
-                left += channel3.execute(toExecute);
-            }
-        }
+    if (config.bandLimiting) {
+        synthesizeBandLimited(cycles, n);
+        return;
+    }
+
+    // Run the state machines of all enabled channels
+    if (GET_BIT(dmaEnabled, 0)) {
+        channel0.execute(cycles, sample[0], NULL, n);
+    } else {
+        memset(sample[0], 0, n * sizeof(int16_t));
+    }
+    if (GET_BIT(dmaEnabled, 1)) {
+        channel1.execute(cycles, sample[1], NULL, n);
+    } else {
+        memset(sample[1], 0, n * sizeof(int16_t));
+    }
+    if (GET_BIT(dmaEnabled, 2)) {
+        channel2.execute(cycles, sample[2], NULL, n);
+    } else {
+        memset(sample[2], 0, n * sizeof(int16_t));
+    }
+    if (GET_BIT(dmaEnabled, 3)) {
+        channel3.execute(cycles, sample[3], NULL, n);
+    } else {
+        memset(sample[3], 0, n * sizeof(int16_t));
+    }
 
-        // Write sound samples into buffers
-        writeData(left, right);
+    // Mix channels 0 and 3 to the left and channels 1 and 2 to the right
+    for (size_t i = 0; i < n; i++) {
+        left[i] = (float)(int16_t)(sample[0][i] + sample[3][i]);
+        right[i] = (float)(int16_t)(sample[1][i] + sample[2][i]);
     }
+
+    // Write sound samples into buffers
+    writeData(left, right, n);
 }
 
-AudioInfo
-AudioUnit::getInfo()
+void
+AudioUnit::synthesizeBandLimited(const DMACycle *cycles, size_t n)
 {
-    AudioInfo result;
+    int16_t sample[4][synthBlockSize];
+    DMACycle offset[4][synthBlockSize];
+    float left[synthBlockSize];
+    float right[synthBlockSize];
 
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
+    static_assert(synthBlockSize <= BlepBuffer::maxBlockSize, "Block too large");
 
-    return result;
+    // Run the state machines of all enabled channels
+    if (GET_BIT(dmaEnabled, 0)) {
+        channel0.execute(cycles, sample[0], offset[0], n);
+    } else {
+        memset(sample[0], 0, n * sizeof(int16_t));
+        memset(offset[0], 0, n * sizeof(DMACycle));
+    }
+    if (GET_BIT(dmaEnabled, 1)) {
+        channel1.execute(cycles, sample[1], offset[1], n);
+    } else {
+        memset(sample[1], 0, n * sizeof(int16_t));
+        memset(offset[1], 0, n * sizeof(DMACycle));
+    }
+    if (GET_BIT(dmaEnabled, 2)) {
+        channel2.execute(cycles, sample[2], offset[2], n);
+    } else {
+        memset(sample[2], 0, n * sizeof(int16_t));
+        memset(offset[2], 0, n * sizeof(DMACycle));
+    }
+    if (GET_BIT(dmaEnabled, 3)) {
+        channel3.execute(cycles, sample[3], offset[3], n);
+    } else {
+        memset(sample[3], 0, n * sizeof(int16_t));
+        memset(offset[3], 0, n * sizeof(DMACycle));
+    }
+
+    // Convert all output changes into band-limited steps
+    for (int c = 0; c < 4; c++) {
+
+        // Channels 0 and 3 are routed to the left, 1 and 2 to the right
+        BlepBuffer &blep = (c == 0 || c == 3) ? blepL : blepR;
+
+        for (size_t i = 0; i < n; i++) {
+
+            if (sample[c][i] == channelOutput[c]) continue;
+
+            // Sample i is taken at the end of the i-th interval
+            double time = cycles[i] ? i - (double)offset[c][i] / cycles[i] : i;
+            blep.addStep(time, sample[c][i] - channelOutput[c]);
+            channelOutput[c] = sample[c][i];
+        }
+    }
+
+    // Integrate the steps
+    blepL.read(left, n);
+    blepR.read(right, n);
+
+    // Write sound samples into buffers
+    writeData(left, right, n);
+}
+
+AudioInfo
+AudioUnit::getInfo()
+{
+    return infoBuffer.read();
 }
 
 void
@@ -211,139 +305,255 @@ AudioUnit::clearRingbuffer()
 {
     debug(AUDBUF_DEBUG, "Clearing ringbuffer\n");
     
-    // Wipe out the ringbuffers
-    for (unsigned i = 0; i < bufferSize; i++) {
-        ringBufferL[i] = ringBufferR[i] = 0.0;
-    }
+    // Hand over all pending samples
+    flushBlock();
 
     // Wipe out the filter buffers
     filterL.clear();
     filterR.clear();
 
-    // Put the write pointer ahead of the read pointer
-    alignWritePtr();
+    /* Make the consumer drop all buffered samples. It plays back silence
+     * until enough new samples have been written.
+     */
+    stream.requestDiscard();
 }
 
-void
-AudioUnit::readMonoSample(float *mono)
+float
+AudioUnit::ringbufferDataL(size_t offset)
 {
-    float left, right;
+    return stream.peekL(offset);
+}
+
+float
+AudioUnit::ringbufferDataR(size_t offset)
+{
+    return stream.peekR(offset);
+}
 
-    readStereoSample(&left, &right);
-    *mono = left + right;
+float
+AudioUnit::ringbufferData(size_t offset)
+{
+    return ringbufferDataL(offset) + ringbufferDataR(offset);
 }
 
 void
-AudioUnit::readStereoSample(float *left, float *right)
+AudioUnit::fetchSamples(float *left, float *right, size_t n)
 {
-    // Read sound samples
-    float l = ringBufferL[readPtr];
-    float r = ringBufferR[readPtr];
+    size_t count = 0;
+
+    // In offline mode, the ringbuffer isn't fed
+    if (offline) {
+        memset(left, 0, n * sizeof(float));
+        memset(right, 0, n * sizeof(float));
+        return;
+    }
 
-    // Modify volume
-    if (volume != targetVolume) {
-        if (volume < targetVolume) {
-            volume += MIN(volumeDelta, targetVolume - volume);
+    // Carry out a pending discard request
+    if (stream.discardRequested()) {
+
+        stream.skip(stream.count());
+        rebuffering = true;
+    }
+
+    // Carry out a pending alignment request
+    if (stream.alignmentRequested()) {
+
+        size_t available = stream.count();
+        if (available > samplesAhead) {
+            stream.skip(available - samplesAhead);
         } else {
-            volume -= MIN(volumeDelta, volume - targetVolume);
+            rebuffering = true;
         }
     }
 
-    // Apply volume
-    float divider = 10000.0f;
-    if (volume > 0) {
-        l *= (float)volume / divider;
-        r *= (float)volume / divider;
-    } else {
-        l = 0.0;
-        r = 0.0;
+    // Wait until enough samples have been buffered
+    if (rebuffering && stream.count() >= samplesAhead) {
+        rebuffering = false;
     }
 
-    // Advance read pointer
-    advanceReadPtr();
+    // Read sound samples
+    if (!rebuffering) {
 
-    // Write result
-    *left = l;
-    *right = r;
-}
+        count = stream.read(left, right, n);
 
-float
-AudioUnit::ringbufferDataL(size_t offset)
-{
-    return ringBufferL[(readPtr + offset) % bufferSize];
-}
+        // Check for a buffer underflow
+        if (count < n) handleBufferUnderflow();
+    }
 
-float
-AudioUnit::ringbufferDataR(size_t offset)
-{
-    return ringBufferR[(readPtr + offset) % bufferSize];
+    // Fill up with silence
+    for (size_t i = count; i < n; i++) {
+        left[i] = right[i] = 0.0;
+    }
 }
 
-float
-AudioUnit::ringbufferData(size_t offset)
+void
+AudioUnit::applyVolume(float *left, float *right, size_t n)
 {
-    return ringbufferDataL(offset) + ringbufferDataR(offset);
+    float divider = 10000.0f;
+
+    for (size_t i = 0; i < n; i++) {
+
+        // Modify volume
+        if (volume != targetVolume) {
+            if (volume < targetVolume) {
+                volume += MIN(volumeDelta, targetVolume - volume);
+            } else {
+                volume -= MIN(volumeDelta, volume - targetVolume);
+            }
+        }
+
+        // Apply volume
+        if (volume > 0) {
+            left[i] *= (float)volume / divider;
+            right[i] *= (float)volume / divider;
+        } else {
+            left[i] = 0.0;
+            right[i] = 0.0;
+        }
+    }
 }
 
 void
 AudioUnit::readMonoSamples(float *target, size_t n)
 {
-    // Check for a buffer underflow
-    if (samplesInBuffer() < n) {
-        handleBufferUnderflow();
-    }
-    
-    // Read sound samples
-    for (size_t i = 0; i < n; i++) {
-        readMonoSample(target + i);
+    float left[blockSize], right[blockSize];
+
+    for (size_t i = 0; i < n; i += blockSize) {
+
+        size_t chunk = MIN(n - i, blockSize);
+
+        fetchSamples(left, right, chunk);
+        applyVolume(left, right, chunk);
+
+        for (size_t j = 0; j < chunk; j++) {
+            target[i + j] = left[j] + right[j];
+        }
     }
 }
 
 void
 AudioUnit::readStereoSamples(float *target1, float *target2, size_t n)
 {
-    // Check for a buffer underflow
-    if (samplesInBuffer() < n)
-        handleBufferUnderflow();
-    
-    // Read sound samples
-    for (unsigned i = 0; i < n; i++)
-        readStereoSample(target1 + i, target2 + i);
+    fetchSamples(target1, target2, n);
+    applyVolume(target1, target2, n);
 }
 
 void
 AudioUnit::readStereoSamplesInterleaved(float *target, size_t n)
 {
-    // Check for a buffer underflow
-    if (samplesInBuffer() < n)
-        handleBufferUnderflow();
-    
-    // Read sound samples
-    for (unsigned i = 0; i < n; i++)
-        readStereoSample(target + 2*i, target + 2*i + 1);
+    float left[blockSize], right[blockSize];
+
+    for (size_t i = 0; i < n; i += blockSize) {
+
+        size_t chunk = MIN(n - i, blockSize);
+
+        fetchSamples(left, right, chunk);
+        applyVolume(left, right, chunk);
+
+        for (size_t j = 0; j < chunk; j++) {
+            target[2 * (i + j)] = left[j];
+            target[2 * (i + j) + 1] = right[j];
+        }
+    }
+}
+
+void
+AudioUnit::writeData(const float *left, const float *right, size_t n)
+{
+    bool filter =
+    (config.filterActivation == FILTACT_POWER_LED && ciaa.powerLED()) ||
+    (config.filterActivation == FILTACT_ALWAYS);
+
+    while (n > 0) {
+
+        size_t chunk = MIN(n, blockSize - blockFill);
+        float *l = blockL + blockFill;
+        float *r = blockR + blockFill;
+
+        // Scale the samples
+        for (size_t i = 0; i < chunk; i++) {
+            l[i] = left[i] * scale;
+            r[i] = right[i] * scale;
+        }
+
+        // Apply audio filter if applicable
+        if (filter) {
+            for (size_t i = 0; i < chunk; i++) {
+                l[i] = filterL.apply(l[i]);
+                r[i] = filterR.apply(r[i]);
+            }
+        }
+
+        // Advance to the next chunk
+        blockFill += chunk;
+        if (blockFill == blockSize) flushBlock();
+        left += chunk;
+        right += chunk;
+        n -= chunk;
+        amiga.counters.audioSamples += chunk;
+    }
 }
 
 void
-AudioUnit::writeData(short left, short right)
+AudioUnit::flushBlock()
 {
-    // Check for buffer overflow
-    if (bufferCapacity() == 0) handleBufferOverflow();
+    if (blockFill == 0) return;
 
-    // Convert samples to floating point values
-    float fl = float(left) * scale;
-    float fr = float(right) * scale;
+    if (!offline) {
 
-    // Apply audio filter if applicable
-    if ((config.filterActivation == FILTACT_POWER_LED && ciaa.powerLED()) ||
-        (config.filterActivation == FILTACT_ALWAYS)) {
-        fl = filterL.apply(fl);
-        fr = filterR.apply(fr);
+        // Check for buffer overflow
+        if (stream.free() < blockFill) handleBufferOverflow();
+
+        // Write samples into ringbuffer (samples that don't fit are dropped)
+        stream.write(blockL, blockR, blockFill);
     }
 
-    // Write samples into ringbuffer
-    ringBufferL[writePtr] = fl;
-    ringBufferR[writePtr] = fr;
-    advanceWritePtr();
+    // Pass samples to all connected sinks
+    if (!sinks.empty()) {
+
+        float left[blockSize], right[blockSize];
+        const float normalize = 1.0f / (32768.0f * scale);
+
+        for (size_t i = 0; i < blockFill; i++) {
+            left[i] = blockL[i] * normalize;
+            right[i] = blockR[i] * normalize;
+        }
+        for (AudioSink *sink : sinks) {
+            sink->consume(left, right, blockFill);
+        }
+    }
+
+    blockFill = 0;
+}
+
+void
+AudioUnit::addSink(AudioSink *sink)
+{
+    assert(sink != NULL);
+
+    amiga.suspend();
+    flushBlock();
+    sinks.push_back(sink);
+    amiga.resume();
+}
+
+void
+AudioUnit::removeSink(AudioSink *sink)
+{
+    amiga.suspend();
+    flushBlock();
+    sinks.erase(std::remove(sinks.begin(), sinks.end(), sink), sinks.end());
+    amiga.resume();
+}
+
+void
+AudioUnit::setOffline(bool value)
+{
+    amiga.suspend();
+    flushBlock();
+    offline = value;
+    if (!offline) alignWritePtr();
+    amiga.resume();
 }
 
 void
@@ -354,7 +564,7 @@ AudioUnit::handleBufferUnderflow()
     // (1) The consumer runs slightly faster than the producer.
     // (2) The producer is halted or not startet yet.
     
-    debug(AUDBUF_DEBUG, "SID RINGBUFFER UNDERFLOW (r: %ld w: %ld)\n", readPtr, writePtr);
+    debug(AUDBUF_DEBUG, "RINGBUFFER UNDERFLOW (fill level: %zu)\n", stream.count());
     
     // Determine the elapsed seconds since the last pointer adjustment.
     uint64_t now = mach_absolute_time();
@@ -371,8 +581,8 @@ AudioUnit::handleBufferUnderflow()
         setSampleRate(getSampleRate() + offPerSecond);
     }
     
-    // Reset the write pointer
-    alignWritePtr();
+    // Wait until the write pointer is ahead of the read pointer again
+    rebuffering = true;
 }
 
 void
@@ -383,7 +593,7 @@ AudioUnit::handleBufferOverflow()
     // (1) The consumer runs slightly slower than the producer.
     // (2) The consumer is halted or not startet yet.
     
-    debug(AUDBUF_DEBUG, "SID RINGBUFFER OVERFLOW (r: %ld w: %ld)\n", readPtr, writePtr);
+    debug(AUDBUF_DEBUG, "RINGBUFFER OVERFLOW (fill level: %zu)\n", stream.count());
     
     // Determine the elapsed seconds since the last pointer adjustment.
     uint64_t now = mach_absolute_time();
@@ -400,6 +610,6 @@ AudioUnit::handleBufferOverflow()
         setSampleRate(getSampleRate() - offPerSecond);
     }
     
-    // Reset the write pointer
+    // Make the consumer skip the surplus samples
     alignWritePtr();
 }
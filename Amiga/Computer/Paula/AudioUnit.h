@@ -13,6 +13,8 @@
 #include "AmigaComponent.h"
 #include "StateMachine.h"
 #include "AudioFilter.h"
+#include "AudioStream.h"
+#include "BlepBuffer.h"
 
 class AudioUnit : public AmigaComponent {
 
@@ -22,6 +24,9 @@ class AudioUnit : public AmigaComponent {
     // Information shown in the GUI inspector panel
     AudioInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<AudioInfo> infoBuffer;
+
 
     // Sub components
     //
@@ -38,6 +43,10 @@ public:
     AudioFilter filterL;
     AudioFilter filterR;
 
+    // Band-limited step synthesizers
+    BlepBuffer blepL;
+    BlepBuffer blepR;
+
     
     //
     // Properties
@@ -70,10 +79,35 @@ private:
     
     /* The audio sample ringbuffer.
      * This ringbuffer serves as the data interface between the emulation code
-     * and the audio API (CoreAudio on Mac OS X).
+     * and the audio API (CoreAudio on Mac OS X). It is written by the emulator
+     * thread and read by the audio thread.
+     */
+    AudioStream<bufferSize> stream;
+
+    /* Staging area for newly generated samples
+     * Samples are collected here and handed over to the ringbuffer and all
+     * connected sinks in blocks.
+     */
+    static constexpr size_t blockSize = 512;
+    float blockL[blockSize];
+    float blockR[blockSize];
+    size_t blockFill = 0;
+
+    // Additional consumers of the generated audio stream
+    vector<AudioSink *> sinks;
+
+    /* Indicates if the audio unit renders offline
+     * In offline mode, samples are passed to the sinks, only. The ringbuffer
+     * is bypassed which makes it possible to render audio at warp speed
+     * without causing buffer overflows.
      */
-    float ringBufferL[bufferSize];
-    float ringBufferR[bufferSize];
+    bool offline = false;
+
+    /* Indicates that the consumer waits for the ringbuffer to fill up
+     * While this flag is set, silence is played back. This variable is
+     * accessed by the consumer thread, only.
+     */
+    bool rebuffering = true;
 
     /* Scaling value for sound samples
      * All sound samples produced by reSID are scaled by this value before they
@@ -82,14 +116,6 @@ private:
     // static constexpr float scale = 0.000005f;
     static constexpr float scale = 0.0000025f;
     
-    /* Ring buffer read pointer
-     */
-    uint32_t readPtr = 0;
-    
-    /* Ring buffer write pointer
-     */
-    uint32_t writePtr = 0;
-    
     /* Current volume
      * A value of 0 or below silences the audio playback.
      */
@@ -126,6 +152,9 @@ private:
     // Used in executeUntil() to compute the number of samples to generate.
     double dmaCycleCounter1 = 0;
     double dmaCycleCounter2 = 0;
+
+    // The most recent output of all four channels (band-limited synthesis)
+    int16_t channelOutput[4];
     
     //
     // Constructing and destructing
@@ -146,7 +175,8 @@ public:
         worker
 
         & config.filterActivation
-        & config.filterType;
+        & config.filterType
+        & config.bandLimiting;
     }
 
     template <class T>
@@ -174,6 +204,9 @@ public:
     FilterType getFilterType();
     void setFilterType(FilterType type);
 
+    bool getBandLimiting() { return config.bandLimiting; }
+    void setBandLimiting(bool value);
+
     //
     // Methods from HardwareComponent
     //
@@ -224,19 +257,12 @@ public:
     // Returns the size of the ringbuffer
     size_t ringbufferSize() { return bufferSize; }
     
-    // Returns the position of the read pointer
-    uint32_t getReadPtr() { return readPtr; }
-    
-    // Returns the position of the write pointer
-    uint32_t getWritePtr() { return writePtr; }
-    
-    // Clears the ringbuffer and resets the read and write pointer
+    /* Clears the ringbuffer
+     * All buffered samples are dropped by the consumer, which plays back
+     * silence until the buffer has been refilled.
+     */
     void clearRingbuffer();
 
-    // Reads sound samples from the sample buffers
-    void readMonoSample(float *mono);
-    void readStereoSample(float *left, float *right);
-
     // Reads a single audio sample without moving the read pointer
     float ringbufferDataL(size_t offset);
     float ringbufferDataR(size_t offset);
@@ -257,9 +283,25 @@ public:
      */
     void readStereoSamplesInterleaved(float *target, size_t n);
     
-    /* Writes a stereo sample into the ringbuffer
+private:
+    
+    /* Fetches samples from the ringbuffer (consumer side)
+     * Missing samples are filled with silence.
+     */
+    void fetchSamples(float *left, float *right, size_t n);
+    
+    // Applies the current volume to a block of samples (consumer side)
+    void applyVolume(float *left, float *right, size_t n);
+    
+public:
+    
+    /* Writes a block of stereo samples into the staging area
      */
-    void writeData(short left, short right);
+    void writeData(const float *left, const float *right, size_t n);
+    
+    /* Hands over all staged samples to the ringbuffer and the sinks
+     */
+    void flushBlock();
     
     /* Handles a buffer underflow condition.
      * A buffer underflow occurs when the computer's audio device needs sound
@@ -276,29 +318,37 @@ public:
     // Signals to ignore the next underflow or overflow condition.
     void ignoreNextUnderOrOverflow() { lastAlignment = mach_absolute_time(); }
     
-    // Moves the read pointer forward
-    void advanceReadPtr() { readPtr = (readPtr + 1) % bufferSize; }
-    void advanceReadPtr(int steps) { readPtr = (readPtr + bufferSize + steps) % bufferSize; }
-    
-    // Moves the write pointer forward.
-    void advanceWritePtr() { writePtr = (writePtr + 1) % bufferSize; }
-    void advanceWritePtr(int steps) { writePtr = (writePtr + bufferSize + steps) % bufferSize; }
-    
     // Returns number of stored samples in the ringbuffer.
-    unsigned samplesInBuffer() { return (writePtr + bufferSize - readPtr) % bufferSize; }
+    unsigned samplesInBuffer() { return (unsigned)stream.count(); }
     
     // Returns the remaining storage capacity of the ringbuffer.
-    unsigned bufferCapacity() { return (readPtr + bufferSize - writePtr) % bufferSize; }
+    unsigned bufferCapacity() { return (unsigned)stream.free(); }
     
     // Returns the fill level as a percentage value.
     double fillLevel() { return (double)samplesInBuffer() / (double)bufferSize; }
     
     /* Aligns the write pointer.
      * This function puts the write pointer somewhat ahead of the read pointer.
-     * With a standard sample rate of 44100 Hz, 735 samples is 1/60 sec.
+     * With a standard sample rate of 44100 Hz, 735 samples is 1/60 sec. The
+     * alignment is carried out by the consumer when it reads the next block.
      */
     const uint32_t samplesAhead = 8 * 735;
-    void alignWritePtr() { writePtr = (readPtr  + samplesAhead) % bufferSize; }
+    void alignWritePtr() { stream.requestAlignment(); }
+
+
+    //
+    // Managing sinks
+    //
+    
+    /* Connects or disconnects an additional consumer
+     * The emulator is suspended while the list of sinks is modified.
+     */
+    void addSink(AudioSink *sink);
+    void removeSink(AudioSink *sink);
+
+    // Enables or disables offline rendering
+    bool isOffline() { return offline; }
+    void setOffline(bool value);
 
 
     //
@@ -311,8 +361,25 @@ public:
     void enableDMA(int nr);
     void disableDMA(int nr);
     
-    // Executes the device until the given master clock cycle has been reached.
+    /* Executes the device until the given master clock cycle has been reached.
+     * The samples are synthesized in blocks. The state machines of all four
+     * channels run for a whole block before their outputs are mixed.
+     */
     void executeUntil(Cycle targetClock);
+
+private:
+
+    // Maximum number of samples synthesized in one go
+    static constexpr size_t synthBlockSize = 64;
+
+    // Synthesizes the samples for a block of sampling intervals
+    void synthesize(const DMACycle *cycles, size_t n);
+
+    /* Synthesizes the samples for a block of sampling intervals with band-
+     * limited steps. The output of each channel is treated as a step
+     * function. The step positions are determined with sub-sample precision.
+     */
+    void synthesizeBandLimited(const DMACycle *cycles, size_t n);
 };
 
 #endif
@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+float BlepBuffer::kernel[BlepBuffer::phases + 1][BlepBuffer::taps];
+
+BlepBuffer::BlepBuffer()
+{
+    // Setup the kernel table (only once)
+    static bool initialized = [] {
+        initKernel();
+        return true;
+    }();
+    (void)initialized;
+
+    clear();
+}
+
+void
+BlepBuffer::initKernel()
+{
+    // Cutoff frequency relative to the sample rate
+    const double cutoff = 0.45;
+
+    // Distance between the first tap and the center of the impulse
+    const double center = taps / 2 - 1;
+
+    for (int p = 0; p <= phases; p++) {
+
+        double sum = 0.0;
+        double impulse[taps];
+
+        for (int k = 0; k < taps; k++) {
+
+            // Distance between this tap and the step
+            double x = k - (double)p / phases - center;
+
+            // Windowed sinc (Blackman window)
+            double s = x == 0.0 ? 1.0 : sin(M_PI * 2 * cutoff * x) / (M_PI * 2 * cutoff * x);
+            double w = fabs(x) >= taps / 2 ? 0.0 :
+            0.42 + 0.5 * cos(M_PI * x / (taps / 2)) + 0.08 * cos(2 * M_PI * x / (taps / 2));
+
+            impulse[k] = s * w;
+            sum += impulse[k];
+        }
+
+        // Normalize the impulse to make the step reach its full height
+        for (int k = 0; k < taps; k++) {
+            kernel[p][k] = (float)(impulse[k] / sum);
+        }
+    }
+}
+
+void
+BlepBuffer::clear()
+{
+    memset(delta, 0, sizeof(delta));
+    level = 0.0;
+}
+
+void
+BlepBuffer::read(float *buffer, size_t n)
+{
+    assert(n <= maxBlockSize);
+
+    // Integrate the delta buffer
+    for (size_t i = 0; i < n; i++) {
+        level += delta[i];
+        buffer[i] = level;
+    }
+
+    // Remove the consumed deltas
+    size_t count = sizeof(delta) / sizeof(float);
+    memmove(delta, delta + n, (count - n) * sizeof(float));
+    memset(delta + count - n, 0, n * sizeof(float));
+}
@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _BLEP_BUFFER_INC
+#define _BLEP_BUFFER_INC
+
+#include <stddef.h>
+
+/* Band-limited step synthesizer
+ *
+ * Paula's output is a step function which changes its value whenever a
+ * channel moves on to the next sample byte or the volume changes. Sampling
+ * this function at the host's sample rate causes aliasing, because the steps
+ * contain frequencies far beyond the Nyquist frequency.
+ *
+ * This class renders each step as a band-limited step (BLEP). For each step,
+ * the derivative of the band-limited step (a windowed sinc impulse) is added
+ * to a delta buffer. The output is obtained by integrating the delta buffer.
+ * The impulse is precomputed for a fixed number of sub-sample phases which
+ * makes the synthesizer work for arbitrary output sample rates. The costs
+ * depend on the number of steps rather than on the number of samples.
+ *
+ * The output is delayed by taps / 2 samples.
+ */
+class BlepBuffer {
+
+public:
+
+    // Number of filter taps per step
+    static const int taps = 16;
+
+    // Number of sub-sample phases
+    static const int phases = 64;
+
+    // Maximum number of samples that can be produced in one go
+    static const size_t maxBlockSize = 256;
+
+private:
+
+    /* Precomputed band-limited impulses (one for each phase)
+     * The table is shared by all instances and set up by the first one.
+     */
+    static float kernel[phases + 1][taps];
+
+    // The delta buffer
+    float delta[maxBlockSize + taps + 1];
+
+    // The integrator state (current output level)
+    float level;
+
+public:
+
+    BlepBuffer();
+
+    // Resets the buffer to silence
+    void clear();
+
+    /* Adds a step of the specified height.
+     * The time is measured in samples relative to the start of the current
+     * block and must lie inside the interval [-1; maxBlockSize).
+     */
+    void addStep(double time, float height)
+    {
+        int pos = (int)(time + 1.0);
+        int phase = (int)((time + 1.0 - pos) * phases + 0.5);
+
+        assert(pos >= 0 && pos < (int)maxBlockSize + 1);
+        assert(phase >= 0 && phase <= phases);
+
+        const float *k = kernel[phase];
+        float *d = delta + pos;
+        for (int i = 0; i < taps; i++) d[i] += height * k[i];
+    }
+
+    // Produces the next n samples
+    void read(float *buffer, size_t n);
+
+private:
+
+    // Sets up the kernel table
+    static void initKernel();
+};
+
+#endif
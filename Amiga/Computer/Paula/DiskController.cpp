@@ -47,8 +47,6 @@ DiskController::_ping()
 void
 DiskController::_inspect()
 {
-    pthread_mutex_lock(&lock);
-
     info.selectedDrive = selected;
     info.state = state;
     info.fifoCount = fifoCount;
@@ -60,7 +58,8 @@ DiskController::_inspect()
     for (unsigned i = 0; i < 6; i++) {
         info.fifo[i] = (fifo >> (8 * i)) & 0xFF;
     }
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void
@@ -106,13 +105,7 @@ DiskController::spinning()
 DiskControllerInfo
 DiskController::getInfo()
 {
-    DiskControllerInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
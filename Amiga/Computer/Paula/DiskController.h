@@ -22,6 +22,9 @@ class DiskController : public AmigaComponent {
     // Information shown in the GUI inspector panel
     DiskControllerInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<DiskControllerInfo> infoBuffer;
+
     // Statistics shown in the GUI monitor panel
     DiskControllerStats stats;
 
@@ -35,14 +35,11 @@ Paula::_reset()
 void
 Paula::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-    
     info.intreq = intreq;
     info.intena = intena;
     info.adkcon = adkcon;
-    
-    pthread_mutex_unlock(&lock);
+
+    infoBuffer.write(info);
 }
 
 void
@@ -54,13 +51,7 @@ Paula::_dump()
 PaulaInfo
 Paula::getInfo()
 {
-    PaulaInfo result;
-    
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-    
-    return result;
+    return infoBuffer.read();
 }
 
 void
@@ -11,6 +11,7 @@
 #define _PAULA_INC
 
 #include "AudioUnit.h"
+#include "WavWriter.h"
 #include "DiskController.h"
 #include "UART.h"
 
@@ -20,6 +21,9 @@ private:
 
     // Information shown in the GUI inspector panel
     PaulaInfo info;
+
+    // The most recently published version of 'info'
+    InfoBuffer<PaulaInfo> infoBuffer;
     
     
     //
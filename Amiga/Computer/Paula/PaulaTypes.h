@@ -127,6 +127,9 @@ typedef struct
 
     // Selected audio filter type
     FilterType filterType;
+
+    // Indicates if the output is synthesized with band-limited steps
+    bool bandLimiting;
 }
 AudioConfig;
 
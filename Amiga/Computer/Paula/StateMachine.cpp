@@ -25,9 +25,6 @@ StateMachine<nr>::StateMachine(Amiga& ref) : AmigaComponent(ref)
 template <int nr> void
 StateMachine<nr>::_inspect()
 {
-    // Prevent external access to variable 'info'
-    pthread_mutex_lock(&lock);
-
     info.state = state;
     info.audlenLatch = audlenLatch;
     info.audlen = audlen;
@@ -39,19 +36,13 @@ StateMachine<nr>::_inspect()
     info.auddat = auddat;
     info.audlcLatch = audlcLatch;
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 template <int nr> AudioChannelInfo
 StateMachine<nr>::getInfo()
 {
-    AudioChannelInfo result;
-
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-
-    return result;
+    return infoBuffer.read();
 }
 
 template <int nr> void
@@ -139,6 +130,8 @@ StateMachine<nr>::irqIsPending()
 template <int nr> int16_t
 StateMachine<nr>::execute(DMACycle cycles)
 {
+    overshoot = 0;
+
     switch(state) {
 
         case 0b000: // State 0 (Idle)
@@ -165,6 +158,7 @@ StateMachine<nr>::execute(DMACycle cycles)
 
             if (audper < 0) {
 
+                overshoot = MIN(-audper, cycles);
                 audper += audperLatch;
                 audvol = audvolLatch;
 
@@ -185,6 +179,7 @@ StateMachine<nr>::execute(DMACycle cycles)
             if (audper > 1) break;
 
             // Reload the period counter
+            overshoot = MIN(1 - audper, cycles);
             audper += audperLatch;
 
             // ??? Can't find this in the state machine (from WinFellow?)
@@ -258,6 +253,24 @@ StateMachine<nr>::execute(DMACycle cycles)
     return (int8_t)auddat * audvolLatch;
 }
 
+template <int nr> void
+StateMachine<nr>::execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n)
+{
+    if (offsets) {
+
+        for (size_t i = 0; i < n; i++) {
+            samples[i] = execute(cycles[i]);
+            offsets[i] = overshoot;
+        }
+
+    } else {
+
+        for (size_t i = 0; i < n; i++) {
+            samples[i] = execute(cycles[i]);
+        }
+    }
+}
+
 template StateMachine<0>::StateMachine(Amiga &ref);
 template StateMachine<1>::StateMachine(Amiga &ref);
 template StateMachine<2>::StateMachine(Amiga &ref);
@@ -302,3 +315,8 @@ template int16_t StateMachine<0>::execute(DMACycle cycles);
 template int16_t StateMachine<1>::execute(DMACycle cycles);
 template int16_t StateMachine<2>::execute(DMACycle cycles);
 template int16_t StateMachine<3>::execute(DMACycle cycles);
+
+template void StateMachine<0>::execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n);
+template void StateMachine<1>::execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n);
+template void StateMachine<2>::execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n);
+template void StateMachine<3>::execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n);
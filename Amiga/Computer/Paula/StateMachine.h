@@ -24,6 +24,9 @@ class StateMachine : public AmigaComponent {
     // Information shown in the GUI inspector panel
     AudioChannelInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<AudioChannelInfo> infoBuffer;
+
 public:
 
     // The current state of this machine
@@ -48,6 +51,12 @@ public:
     // Audio location (AUDxLC)
     uint32_t audlcLatch;
 
+    /* Position of the most recent output change
+     * The value is set by execute() and specifies how many DMA cycles before
+     * the end of the executed interval the output has changed.
+     */
+    DMACycle overshoot;
+
 
     //
     // Constructing and destructing
@@ -157,6 +166,13 @@ public:
      * The return value is the current audio sample of this channel.
      */
     int16_t execute(DMACycle cycles);
+
+    /* Executes the state machine for a block of sampling intervals.
+     * The length of the i-th interval is passed in cycles[i]. The generated
+     * audio sample is written into samples[i]. If offsets is not NULL, the
+     * position of the most recent output change is written into offsets[i].
+     */
+    void execute(const DMACycle *cycles, int16_t *samples, DMACycle *offsets, size_t n);
 };
 
 #endif
@@ -24,14 +24,12 @@ UART::_reset()
 void
 UART::_inspect()
 {
-    pthread_mutex_lock(&lock);
-
     info.receiveBuffer = receiveBuffer;
     info.receiveShiftReg = receiveShiftReg;
     info.transmitBuffer = transmitBuffer;
     info.transmitShiftReg = transmitShiftReg;
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -43,13 +41,7 @@ UART::_dump()
 UARTInfo
 UART::getInfo()
 {
-    UARTInfo result;
-
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-
-    return result;
+    return infoBuffer.read();
 }
 
 uint16_t
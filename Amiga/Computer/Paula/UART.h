@@ -19,6 +19,9 @@ class UART : public AmigaComponent {
     // Information shown in the GUI inspector panel
     UARTInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<UARTInfo> infoBuffer;
+
     // Statistics shown in the GUI monitor panel
     UARTStats stats;
 
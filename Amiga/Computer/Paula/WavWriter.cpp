@@ -0,0 +1,159 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+WavWriter::WavWriter()
+{
+    setDescription("WavWriter");
+}
+
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool
+WavWriter::open(const char *path, uint32_t sampleRate, bool floatFormat)
+{
+    assert(path != NULL);
+
+    close();
+
+    if (!(file = fopen(path, "wb"))) {
+        warn("Cannot create file %s\n", path);
+        return false;
+    }
+
+    this->floatFormat = floatFormat;
+    frames = 0;
+    bufferFill = 0;
+
+    writeHeader(sampleRate);
+    return true;
+}
+
+void
+WavWriter::close()
+{
+    if (!file) return;
+
+    flush();
+
+    // Patch the chunk sizes in the header
+    uint32_t headerSize = floatFormat ? 58 : 44;
+    uint32_t dataSize = (uint32_t)(frames * (floatFormat ? 8 : 4));
+    uint32_t riffSize = dataSize + headerSize - 8;
+
+    fseek(file, 4, SEEK_SET);
+    put32(riffSize);
+    flush();
+    if (floatFormat) {
+        fseek(file, 46, SEEK_SET);
+        put32((uint32_t)frames);
+        flush();
+    }
+    fseek(file, headerSize - 4, SEEK_SET);
+    put32(dataSize);
+    flush();
+
+    fclose(file);
+    file = NULL;
+}
+
+void
+WavWriter::writeHeader(uint32_t sampleRate)
+{
+    uint16_t format = floatFormat ? 3 : 1;
+    uint16_t bytesPerSample = floatFormat ? 4 : 2;
+
+    // RIFF header (the size is patched in close())
+    put32(0x46464952); // "RIFF"
+    put32(0);
+    put32(0x45564157); // "WAVE"
+
+    /* Format chunk
+     * Formats other than PCM carry an extension size field (cbSize), which is
+     * zero for floating point samples.
+     */
+    put32(0x20746D66); // "fmt "
+    put32(floatFormat ? 18 : 16);
+    put16(format);
+    put16(2);
+    put32(sampleRate);
+    put32(sampleRate * 2 * bytesPerSample);
+    put16(2 * bytesPerSample);
+    put16(8 * bytesPerSample);
+    if (floatFormat) put16(0);
+
+    // Fact chunk (required for non-PCM formats, the count is patched in close())
+    if (floatFormat) {
+        put32(0x74636166); // "fact"
+        put32(4);
+        put32(0);
+    }
+
+    // Data chunk (the size is patched in close())
+    put32(0x61746164); // "data"
+    put32(0);
+}
+
+void
+WavWriter::consume(const float *left, const float *right, size_t n)
+{
+    if (!file) return;
+
+    for (size_t i = 0; i < n; i++) {
+
+        if (bufferFill + 8 > bufferSize) flush();
+
+        if (floatFormat) {
+
+            uint32_t l, r;
+            memcpy(&l, left + i, 4);
+            memcpy(&r, right + i, 4);
+            put32(l);
+            put32(r);
+
+        } else {
+
+            float l = MAX(-1.0f, MIN(left[i], 32767.0f / 32768.0f));
+            float r = MAX(-1.0f, MIN(right[i], 32767.0f / 32768.0f));
+            put16((uint16_t)(int16_t)lrintf(l * 32768.0f));
+            put16((uint16_t)(int16_t)lrintf(r * 32768.0f));
+        }
+    }
+
+    frames += n;
+}
+
+void
+WavWriter::flush()
+{
+    if (bufferFill == 0) return;
+
+    if (fwrite(buffer, 1, bufferFill, file) != bufferFill) {
+        warn("Failed to write audio data\n");
+    }
+    bufferFill = 0;
+}
+
+void
+WavWriter::put16(uint16_t value)
+{
+    buffer[bufferFill++] = value & 0xFF;
+    buffer[bufferFill++] = value >> 8;
+}
+
+void
+WavWriter::put32(uint32_t value)
+{
+    put16(value & 0xFFFF);
+    put16(value >> 16);
+}
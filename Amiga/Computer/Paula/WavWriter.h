@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _WAV_WRITER_INC
+#define _WAV_WRITER_INC
+
+#include "AmigaObject.h"
+#include "AudioStream.h"
+
+/* Audio sink writing the generated samples into a WAV file
+ *
+ * Samples are stored as 16-bit integers or as 32-bit floating point values.
+ * They are collected in an internal buffer and written to disk in large
+ * chunks. The file header is completed when the file is closed.
+ *
+ * Typical usage for rendering audio offline:
+ *
+ *     WavWriter writer;
+ *     writer.open("out.wav", 44100, false);
+ *     amiga.paula.audioUnit.addSink(&writer);
+ *     amiga.paula.audioUnit.setOffline(true);
+ *     ... run the emulator in warp mode ...
+ *     amiga.paula.audioUnit.removeSink(&writer);
+ *     writer.close();
+ */
+class WavWriter : public AmigaObject, public AudioSink {
+
+    // The output file (NULL if no file is open)
+    FILE *file = NULL;
+
+    // Indicates if samples are written as floating point values
+    bool floatFormat = false;
+
+    // Number of written stereo samples
+    uint64_t frames = 0;
+
+    // Write buffer
+    static const size_t bufferSize = 65536;
+    uint8_t buffer[bufferSize];
+    size_t bufferFill = 0;
+
+public:
+
+    WavWriter();
+    ~WavWriter();
+
+    /* Creates a new WAV file
+     * Returns false if the file cannot be created.
+     */
+    bool open(const char *path, uint32_t sampleRate, bool floatFormat);
+
+    // Completes the file header and closes the file
+    void close();
+
+    // Returns true if a file is open
+    bool isOpen() { return file != NULL; }
+
+    // Returns the number of written stereo samples
+    uint64_t getFrames() { return frames; }
+
+    // Methods from AudioSink
+    void consume(const float *left, const float *right, size_t n) override;
+
+private:
+
+    // Writes the file header
+    void writeHeader(uint32_t sampleRate);
+
+    // Writes the buffer contents to disk
+    void flush();
+
+    // Writes a little endian value into the write buffer
+    void put16(uint16_t value);
+    void put32(uint32_t value);
+};
+
+#endif
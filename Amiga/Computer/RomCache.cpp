@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+std::multimap<uint32_t, std::weak_ptr<RomImage>> RomCache::images;
+pthread_mutex_t RomCache::lock = PTHREAD_MUTEX_INITIALIZER;
+
+RomImage::RomImage(const uint8_t *buffer, size_t length, uint32_t crc)
+{
+    assert(buffer != NULL);
+    assert(length > 0);
+
+    // We allocate three bytes more than we need to handle the case that a
+    // long word access is performed on the last memory address.
+    size_t pageSize = (size_t)getpagesize();
+    capacity = (length + 3 + pageSize - 1) & ~(pageSize - 1);
+
+    void *addr = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON, -1, 0);
+
+    if (addr == MAP_FAILED) {
+        capacity = 0;
+        return;
+    }
+
+    data = (uint8_t *)addr;
+    size = length;
+    memcpy(data, buffer, length);
+
+    // Write-protect the image
+    mprotect(addr, capacity, PROT_READ);
+
+    fingerprint = crc;
+    revision = Memory::revision(crc);
+}
+
+RomImage::~RomImage()
+{
+    if (data) munmap(data, capacity);
+}
+
+std::shared_ptr<RomImage>
+RomCache::acquire(const uint8_t *buffer, size_t length)
+{
+    assert(buffer != NULL);
+
+    std::shared_ptr<RomImage> result;
+    uint32_t crc = crc32(buffer, length);
+
+    pthread_mutex_lock(&lock);
+
+    auto range = images.equal_range(crc);
+    for (auto it = range.first; it != range.second; ) {
+
+        if (auto image = it->second.lock()) {
+
+            // Compare the contents to rule out CRC collisions
+            if (image->size == length && memcmp(image->data, buffer, length) == 0) {
+                result = image;
+                break;
+            }
+            it++;
+
+        } else {
+
+            // Remove images that have been freed
+            it = images.erase(it);
+        }
+    }
+
+    if (!result) {
+
+        result = std::make_shared<RomImage>(buffer, length, crc);
+
+        if (result->data) {
+            images.insert(std::make_pair(crc, std::weak_ptr<RomImage>(result)));
+        } else {
+            result = NULL;
+        }
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    return result;
+}
+
+size_t
+RomCache::count()
+{
+    size_t result = 0;
+
+    pthread_mutex_lock(&lock);
+    for (auto &it : images) if (!it.second.expired()) result++;
+    pthread_mutex_unlock(&lock);
+
+    return result;
+}
@@ -0,0 +1,68 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _ROM_CACHE_INC
+#define _ROM_CACHE_INC
+
+#include "AmigaObject.h"
+
+#include <memory>
+
+/* A read-only Rom image
+ * The image data is stored in a separate memory region which is write
+ * protected after the image has been created. The fingerprint (CRC-32) and
+ * the revision are computed once on creation.
+ */
+class RomImage {
+
+public:
+
+    // The image data (padded with three zero bytes)
+    uint8_t *data = NULL;
+
+    // The image size in bytes (without padding)
+    size_t size = 0;
+
+    // Size of the allocated memory region
+    size_t capacity = 0;
+
+    // CRC-32 checksum of the image data
+    uint32_t fingerprint = 0;
+
+    // The Rom identifier derived from the fingerprint
+    RomRevision revision = ROM_UNKNOWN;
+
+    RomImage(const uint8_t *buffer, size_t length, uint32_t crc);
+    ~RomImage();
+};
+
+/* Process-wide cache of Rom images
+ * Rom images are addressed by their contents. If multiple emulator instances
+ * install the same Kickstart or extended Rom, all of them share a single
+ * read-only copy. An image is freed when the last instance releases it.
+ * The cache is thread-safe.
+ */
+class RomCache {
+
+    // Weak references to all living images, indexed by fingerprint
+    static std::multimap<uint32_t, std::weak_ptr<RomImage>> images;
+
+    // Mutex protecting the image table
+    static pthread_mutex_t lock;
+
+public:
+
+    // Returns a shared image with the specified contents
+    static std::shared_ptr<RomImage> acquire(const uint8_t *buffer, size_t length);
+
+    // Returns the number of images in the cache
+    static size_t count();
+};
+
+#endif
@@ -91,14 +91,20 @@ AmigaFile::read()
 void
 AmigaFile::flash(uint8_t *buffer, size_t offset)
 {
-    int byte;
     assert(buffer != NULL);
     
-    seek(0);
-    
-    while ((byte = read()) != EOF) {
-        buffer[offset++] = (uint8_t)byte;
-    }
+    if (data) memcpy(buffer + offset, data, size);
+}
+
+void
+AmigaFile::flash(uint8_t *buffer, size_t offset, size_t length)
+{
+    assert(buffer != NULL);
+
+    size_t count = MIN(length, size);
+
+    if (count) memcpy(buffer + offset, data, count);
+    memset(buffer + offset + count, 0, length - count);
 }
 
 bool
@@ -122,64 +128,108 @@ AmigaFile::readFromBuffer(const uint8_t *buffer, size_t length)
     return true;
 }
 
+uint8_t *
+AmigaFile::map(const char *filename, size_t &length, bool &mapped)
+{
+    struct stat fileProperties;
+    uint8_t *buffer;
+    int fd;
+
+    // Open file
+    if ((fd = open(filename, O_RDONLY)) < 0) {
+        return NULL;
+    }
+
+    // Get file properties
+    if (fstat(fd, &fileProperties) != 0 || fileProperties.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    length = (size_t)fileProperties.st_size;
+
+    // Map file into memory
+    void *addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (addr != MAP_FAILED) {
+
+        buffer = (uint8_t *)addr;
+        mapped = true;
+
+    } else {
+
+        // Fall back to reading the whole file with a single call
+        if (!(buffer = new uint8_t[length])) {
+            close(fd);
+            return NULL;
+        }
+
+        size_t count = 0;
+        while (count < length) {
+            ssize_t n = ::read(fd, buffer + count, length - count);
+            if (n <= 0) break;
+            count += n;
+        }
+
+        if (count != length) {
+            delete[] buffer;
+            close(fd);
+            return NULL;
+        }
+
+        mapped = false;
+    }
+
+    close(fd);
+    return buffer;
+}
+
+void
+AmigaFile::unmap(uint8_t *buffer, size_t length, bool mapped)
+{
+    if (mapped) {
+        munmap(buffer, length);
+    } else {
+        delete[] buffer;
+    }
+}
+
 bool
 AmigaFile::readFromFile(const char *filename)
 {
     assert (filename != NULL);
     
-    bool success = false;
-    uint8_t *buffer = NULL;
-    FILE *file = NULL;
-    struct stat fileProperties;
+    uint8_t *buffer;
+    size_t length;
+    bool mapped;
     
     // Check file type
     if (!fileHasSameType(filename)) {
-        goto exit;
-    }
-    
-    // Get file properties
-    if (stat(filename, &fileProperties) != 0) {
-        goto exit;
-    }
-    
-    // Open file
-    if (!(file = fopen(filename, "r"))) {
-        goto exit;
-    }
-    
-    // Allocate memory
-    if (!(buffer = new uint8_t[fileProperties.st_size])) {
-        goto exit;
+        return false;
     }
     
-    // Read from file
-    int c;
-    for (unsigned i = 0; i < fileProperties.st_size; i++) {
-        c = fgetc(file);
-        if (c == EOF)
-            break;
-        buffer[i] = (uint8_t)c;
+    // Map file into memory
+    if (!(buffer = map(filename, length, mapped))) {
+        return false;
     }
     
-    // Read from buffer
+    /* Read from buffer
+     * The contents are copied, because the object might live much longer than
+     * the file stays unchanged on disk.
+     */
     dealloc();
-    if (!readFromBuffer(buffer, (unsigned)fileProperties.st_size)) {
-        goto exit;
+    bool success = readFromBuffer(buffer, length);
+    unmap(buffer, length, mapped);
+    
+    if (!success) {
+        return false;
     }
     
     setPath(filename);
-    success = true;
     
     debug(1, "File %s read successfully\n", path);
     
-exit:
-    
-    if (file)
-        fclose(file);
-    if (buffer)
-        delete[] buffer;
-    
-    return success;
+    return true;
 }
 
 size_t
@@ -198,7 +248,7 @@ AmigaFile::writeToFile(const char *filename)
 {
     bool success = false;
     uint8_t *data = NULL;
-    FILE *file;
+    FILE *file = NULL;
     size_t filesize;
     
     // Determine file size
@@ -206,12 +256,6 @@ AmigaFile::writeToFile(const char *filename)
     if (filesize == 0)
         return false;
     
-    // Open file
-    assert (filename != NULL);
-    if (!(file = fopen(filename, "w"))) {
-        goto exit;
-    }
-    
     // Allocate memory
     if (!(data = new uint8_t[filesize])) {
         goto exit;
@@ -222,12 +266,14 @@ AmigaFile::writeToFile(const char *filename)
         goto exit;
     }
     
-    // Write to file
-    for (unsigned i = 0; i < filesize; i++) {
-        fputc(data[i], file);
+    // Open file
+    assert (filename != NULL);
+    if (!(file = fopen(filename, "w"))) {
+        goto exit;
     }
     
-    success = true;
+    // Write to file
+    success = fwrite(data, 1, filesize, file) == filesize;
     
 exit:
     
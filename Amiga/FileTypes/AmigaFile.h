@@ -27,7 +27,7 @@ protected:
     
     // The size of this file in bytes
     size_t size = 0;
-    
+
     /* File pointer
      * An offset into the data array with -1 indicating EOF
      */
@@ -53,6 +53,17 @@ public:
     
     // Frees the allocated memory.
     virtual void dealloc();
+
+private:
+
+    /* Maps a file into memory (or reads it in one go if mapping fails)
+     * The returned buffer is only meant to be used while the file is loaded
+     * and must be released with unmap().
+     */
+    static uint8_t *map(const char *filename, size_t &length, bool &mapped);
+    static void unmap(uint8_t *buffer, size_t length, bool mapped);
+
+public:
     
     
     //
@@ -96,6 +107,11 @@ public:
     
     //! Copies the whole file data into a buffer.
     virtual void flash(uint8_t *buffer, size_t offset = 0);
+
+    /* Copies up to 'length' bytes of the file data into a buffer.
+     * If the file is smaller, the remaining bytes are zeroed out.
+     */
+    void flash(uint8_t *buffer, size_t offset, size_t length);
     
     
     //
@@ -126,10 +142,11 @@ public:
     
     /* Deserializes this object from a file.
      *   - path     The name of the file containing the binary representation.
-     * This function uses fileHasSameType() to verify that the buffer
-     * contains a compatible binary representation.
-     * This function requires no custom implementation. It first reads in the
-     * file contents in memory and invokes readFromBuffer afterwards.
+     * This function uses fileHasSameType() and bufferHasSameType() to verify
+     * that the file contains a compatible binary representation.
+     * This function requires no custom implementation. It maps the file into
+     * memory and passes the mapping to readFromBuffer() which copies the
+     * contents into the data array of this object.
      */
     bool readFromFile(const char *filename);
     
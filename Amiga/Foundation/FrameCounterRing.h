@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _FRAME_COUNTER_RING_INC
+#define _FRAME_COUNTER_RING_INC
+
+#include <atomic>
+
+/* Ring buffer storing the performance counters of the most recent frames.
+ *
+ * The buffer is written by the emulator thread at the end of each frame and
+ * can be read by any other thread without suspending the emulator. No locks
+ * are involved. Each element is guarded by a sequence number which is odd
+ * while the element is being written. A reader copies an element and checks
+ * the sequence number afterwards. If the element has been modified in the
+ * meantime, the read is rejected.
+ */
+template <int capacity> class FrameCounterRing
+{
+    // Ringbuffer elements
+    FrameCounters record[capacity];
+
+    // Sequence numbers guarding the elements
+    std::atomic<uint64_t> sequence[capacity];
+
+    // Number of elements written so far
+    std::atomic<long> written;
+
+public:
+
+    // Constructor
+    FrameCounterRing() { clear(); }
+
+    // Deletes all elements (must not be called while readers are active)
+    void clear()
+    {
+        memset(record, 0, sizeof(record));
+        for (int i = 0; i < capacity; i++) sequence[i].store(0);
+        written.store(0);
+    }
+
+    // Returns the number of elements written so far
+    long count() const { return written.load(std::memory_order_acquire); }
+
+    // Adds an element (emulator thread only)
+    void write(const FrameCounters &counters)
+    {
+        long nr = written.load(std::memory_order_relaxed);
+        int i = nr % capacity;
+        uint64_t seq = sequence[i].load(std::memory_order_relaxed);
+
+        sequence[i].store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        record[i] = counters;
+
+        sequence[i].store(seq + 2, std::memory_order_release);
+        written.store(nr + 1, std::memory_order_release);
+    }
+
+    /* Reads the element with the specified number (0 = first frame)
+     * Returns false if the element hasn't been written yet or has already
+     * been overwritten.
+     */
+    bool read(long nr, FrameCounters &result) const
+    {
+        long cnt = count();
+        if (nr < 0 || nr >= cnt || nr < cnt - capacity) return false;
+
+        int i = nr % capacity;
+
+        uint64_t seq1 = sequence[i].load(std::memory_order_acquire);
+        if (seq1 & 1) return false;
+
+        result = record[i];
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t seq2 = sequence[i].load(std::memory_order_relaxed);
+
+        return seq1 == seq2 && result.frame == nr;
+    }
+
+    // Reads the most recently written element
+    bool readLatest(FrameCounters &result) const { return read(count() - 1, result); }
+};
+
+#endif
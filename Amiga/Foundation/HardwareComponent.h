@@ -11,6 +11,7 @@
 #define _AMIGACOMPONENT_INC
 
 #include "AmigaObject.h"
+#include "InfoBuffer.h"
 
 /* Base class for all hardware components
  * This class defines the base functionality of all hardware components.
@@ -166,7 +167,10 @@ public:
      * information shown in the GUI's inspector window and are updated by
      * calling this function. The function is called automatically when the
      * emulator switches to pause state to keep the GUI inspector data up
-     * to date.
+     * to date. At the end, the info variable is published in an InfoBuffer
+     * which the GUI can read without blocking the emulator thread. Costly
+     * formatting tasks such as disassembling are carried out on the reader
+     * side.
      * Note: Because this function accesses the internal emulator state with
      * many non-atomic operations, it must not be called on a running emulator.
      * To query information while the emulator is running, set up an inspection
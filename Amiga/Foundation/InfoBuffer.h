@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _INFO_BUFFER_INC
+#define _INFO_BUFFER_INC
+
+#include <atomic>
+
+/* Publication slot for inspection data (seqlock)
+ *
+ * The emulator thread publishes the info struct of a component with write()
+ * and the GUI picks it up with read(). The writer never blocks. The sequence
+ * number is odd while the writer modifies the buffer and even otherwise. A
+ * reader copies the buffer and checks the sequence number before and
+ * afterwards. If the number was odd or has changed in the meantime, the copy
+ * might be torn and the read is repeated.
+ *
+ * The template parameter must be a plain data type (an info struct).
+ */
+template <class T> class InfoBuffer
+{
+    // The published element
+    T buffer;
+
+    // Twice the number of published elements (plus 1 during a write)
+    std::atomic<uint64_t> sequence;
+
+public:
+
+    // Constructor
+    InfoBuffer()
+    {
+        memset(&buffer, 0, sizeof(buffer));
+        sequence.store(0);
+    }
+
+    // Returns the number of published elements (to detect changes)
+    uint64_t version() const { return sequence.load(std::memory_order_acquire) >> 1; }
+
+    // Publishes an element (emulator thread only)
+    void write(const T &value)
+    {
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+
+        // Mark the buffer as being modified
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        buffer = value;
+
+        // Publish the new element
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Returns a copy of the most recently published element
+    T read() const
+    {
+        T result;
+        uint64_t seq1, seq2;
+
+        do {
+            seq1 = sequence.load(std::memory_order_acquire);
+            result = buffer;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq2 = sequence.load(std::memory_order_relaxed);
+
+        } while ((seq1 & 1) || seq1 != seq2);
+
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,201 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _PROFILER_INC
+#define _PROFILER_INC
+
+/* Host time profiler
+ *
+ * If HOST_PROFILER is defined in va_config.h, the emulator records the host
+ * time spent in the CPU, in Agnus, in all event slots, in Denise, and in the
+ * audio synthesizer. The time is measured in time stamp counter ticks and
+ * attributed to the call stack it has been spent in. At the end of each run, the collected data is
+ * written to a file in folded stack format which can be processed by common
+ * flame graph tools.
+ *
+ * If HOST_PROFILER is not defined, all PROFILE_xxx macros expand to nothing.
+ */
+
+#ifdef HOST_PROFILER
+
+#define PROFILE_ENTER(section) amiga.profiler.enter(section)
+#define PROFILE_LEAVE() amiga.profiler.leave()
+
+#else
+
+#define PROFILE_ENTER(section)
+#define PROFILE_LEAVE()
+
+#endif
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+typedef enum
+{
+    PS_EMULATOR,
+    PS_CPU,
+    PS_AGNUS,
+    PS_REG,
+    PS_RAS,
+    PS_CIAA,
+    PS_CIAB,
+    PS_BPL,
+    PS_DAS,
+    PS_COP,
+    PS_BLT,
+    PS_SEC,
+    PS_DENISE,
+    PS_AUDIO,
+    PS_COUNT
+}
+ProfilerSection;
+
+class Profiler {
+
+    // Maximum number of distinct call stacks
+    static const int MAX_NODES = 256;
+
+    // Node of the call tree
+    struct Node {
+
+        // Parent node (root node points to itself)
+        int parent;
+
+        // The section represented by this node
+        ProfilerSection section;
+
+        // Child nodes (0 = not yet created)
+        int child[PS_COUNT];
+
+        // Accumulated ticks spent in this node, excluding all children
+        uint64_t ticks;
+
+        /* Number of sections entered in this node while the call tree was full
+         * The time spent in these sections is charged to this node.
+         */
+        int overflow;
+    };
+
+    // The call tree (node 0 is the root node)
+    Node node[MAX_NODES];
+
+    // Number of used nodes
+    int nodes;
+
+    // The currently active node
+    int current;
+
+    // Time stamp of the most recent call to enter() or leave()
+    uint64_t stamp;
+
+public:
+
+    Profiler() { clear(); }
+
+    // Returns the current value of the time stamp counter
+    static uint64_t ticks()
+    {
+#ifdef __x86_64__
+        return __rdtsc();
+#else
+        return mach_absolute_time();
+#endif
+    }
+
+    // Deletes all recorded data
+    void clear()
+    {
+        memset(node, 0, sizeof(node));
+        node[0].section = PS_EMULATOR;
+        nodes = 1;
+        current = 0;
+        stamp = ticks();
+    }
+
+    // Starts measuring a new section
+    void enter(ProfilerSection section)
+    {
+        uint64_t now = ticks();
+        node[current].ticks += now - stamp;
+        stamp = now;
+
+        int next = node[current].child[section];
+        if (next == 0) {
+
+            // Stay in the current node if the call tree is full
+            if (nodes == MAX_NODES) { node[current].overflow++; return; }
+
+            next = nodes++;
+            node[next].parent = current;
+            node[next].section = section;
+            node[current].child[section] = next;
+        }
+        current = next;
+    }
+
+    // Stops measuring the current section
+    void leave()
+    {
+        uint64_t now = ticks();
+        node[current].ticks += now - stamp;
+        stamp = now;
+
+        // Leave a section that has not been assigned a node of its own
+        if (node[current].overflow) { node[current].overflow--; return; }
+
+        current = node[current].parent;
+    }
+
+    // Returns the name of a section as used in the report
+    static const char *sectionName(ProfilerSection section)
+    {
+        switch (section) {
+
+            case PS_EMULATOR: return "Emulator";
+            case PS_CPU:      return "CPU";
+            case PS_AGNUS:    return "Agnus";
+            case PS_REG:      return "REG_SLOT";
+            case PS_RAS:      return "RAS_SLOT";
+            case PS_CIAA:     return "CIAA_SLOT";
+            case PS_CIAB:     return "CIAB_SLOT";
+            case PS_BPL:      return "BPL_SLOT";
+            case PS_DAS:      return "DAS_SLOT";
+            case PS_COP:      return "COP_SLOT";
+            case PS_BLT:      return "BLT_SLOT";
+            case PS_SEC:      return "SEC_SLOT";
+            case PS_DENISE:   return "Denise";
+            case PS_AUDIO:    return "Audio";
+            default:          return "???";
+        }
+    }
+
+    // Writes the recorded data in folded stack format (one stack per line)
+    void dump(FILE *file)
+    {
+        for (int i = 0; i < nodes; i++) {
+
+            if (node[i].ticks == 0) continue;
+
+            // Collect the call stack
+            int stack[MAX_NODES], depth = 0;
+            for (int n = i; n != 0; n = node[n].parent) stack[depth++] = n;
+            stack[depth++] = 0;
+
+            // Print the call stack from the root to the leaf
+            for (int d = depth - 1; d >= 0; d--) {
+                fprintf(file, "%s%s", sectionName(node[stack[d]].section), d ? ";" : "");
+            }
+            fprintf(file, " %llu\n", (unsigned long long)node[i].ticks);
+        }
+    }
+};
+
+#endif
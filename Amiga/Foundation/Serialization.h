@@ -128,6 +128,7 @@ public:
     COUNT(const CIAType)
     COUNT(const AgnusRevision)
     COUNT(const DeniseRevision)
+    COUNT(const BoardState)
 
     STRUCT(Event)
     STRUCT(Beam)
@@ -200,6 +201,7 @@ public:
     DESERIALIZE64(CIAType)
     DESERIALIZE64(AgnusRevision)
     DESERIALIZE64(DeniseRevision)
+    DESERIALIZE64(BoardState)
 
     STRUCT(Event)
     STRUCT(Beam)
@@ -278,6 +280,7 @@ public:
     SERIALIZE64(const CIAType)
     SERIALIZE64(const AgnusRevision)
     SERIALIZE64(const DeniseRevision)
+    SERIALIZE64(const BoardState)
 
     STRUCT(Event)
     STRUCT(Beam)
@@ -345,6 +348,7 @@ public:
     RESET(DriveState)
     RESET(DrawingMode)
     RESET(RTCModel)
+    RESET(BoardState)
 
     STRUCT(Event)
     STRUCT(Beam)
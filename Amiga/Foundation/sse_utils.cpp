@@ -40,3 +40,74 @@ void transposeSSE(uint16_t *source, uint8_t* target)
     // Read the result back from the SSE registers
     _mm_store_si128((__m128i *)target, shuffled);
 }
+
+// Selects the table entries for the values in the row of the given number
+static inline __m128i
+lookupRow(__m128i table, __m128i column, __m128i row, int nr)
+{
+    __m128i entries = _mm_shuffle_epi8(table, column);
+    return _mm_and_si128(entries, _mm_cmpeq_epi8(row, _mm_set1_epi8(nr)));
+}
+
+// Looks up 16 values in a table that has been split into four rows
+static inline __m128i
+lookup(const __m128i table[4], __m128i column, __m128i row)
+{
+    __m128i result = lookupRow(table[0], column, row, 0);
+    result = _mm_or_si128(result, lookupRow(table[1], column, row, 1));
+    result = _mm_or_si128(result, lookupRow(table[2], column, row, 2));
+    result = _mm_or_si128(result, lookupRow(table[3], column, row, 3));
+    return result;
+}
+
+void lookupSSE(const uint8_t *source, size_t count,
+               const uint8_t *table, uint8_t *target)
+{
+    const __m128i rows[4] = {
+        _mm_loadu_si128((__m128i *)(table + 0)),
+        _mm_loadu_si128((__m128i *)(table + 16)),
+        _mm_loadu_si128((__m128i *)(table + 32)),
+        _mm_loadu_si128((__m128i *)(table + 48))
+    };
+    
+    for (size_t i = 0; i < count; i += 16) {
+        
+        // Split the values into the column (bits 0 - 3) and the row (bits 4, 5)
+        __m128i values = _mm_loadu_si128((__m128i *)(source + i));
+        __m128i column = _mm_and_si128(values, _mm_set1_epi8(0x0F));
+        __m128i row = _mm_and_si128(_mm_srli_epi16(values, 4), _mm_set1_epi8(0x03));
+        
+        _mm_storeu_si128((__m128i *)(target + i), lookup(rows, column, row));
+    }
+}
+
+void lookup16SSE(const uint8_t *source, size_t count,
+                 const uint8_t *tableLo, const uint8_t *tableHi, uint16_t *target)
+{
+    const __m128i rowsLo[4] = {
+        _mm_loadu_si128((__m128i *)(tableLo + 0)),
+        _mm_loadu_si128((__m128i *)(tableLo + 16)),
+        _mm_loadu_si128((__m128i *)(tableLo + 32)),
+        _mm_loadu_si128((__m128i *)(tableLo + 48))
+    };
+    const __m128i rowsHi[4] = {
+        _mm_loadu_si128((__m128i *)(tableHi + 0)),
+        _mm_loadu_si128((__m128i *)(tableHi + 16)),
+        _mm_loadu_si128((__m128i *)(tableHi + 32)),
+        _mm_loadu_si128((__m128i *)(tableHi + 48))
+    };
+    
+    for (size_t i = 0; i < count; i += 16) {
+        
+        // Split the values into the column (bits 0 - 3) and the row (bits 4, 5)
+        __m128i values = _mm_loadu_si128((__m128i *)(source + i));
+        __m128i column = _mm_and_si128(values, _mm_set1_epi8(0x0F));
+        __m128i row = _mm_and_si128(_mm_srli_epi16(values, 4), _mm_set1_epi8(0x03));
+        
+        // Look up both bytes and merge them into 16 bit values
+        __m128i lo = lookup(rowsLo, column, row);
+        __m128i hi = lookup(rowsHi, column, row);
+        _mm_storeu_si128((__m128i *)(target + i), _mm_unpacklo_epi8(lo, hi));
+        _mm_storeu_si128((__m128i *)(target + i + 8), _mm_unpackhi_epi8(lo, hi));
+    }
+}
@@ -11,6 +11,7 @@
 #define _SEE_UTILS_INC
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* Transposes a 8 x 16 bit matrix using SSE3 extensions
  *
@@ -34,4 +35,29 @@
  */
 void transposeSSE(uint16_t p[8], uint8_t* result);
 
+/* Translates 6 bit values with a lookup table using SSSE3 extensions
+ *
+ *     Input:   A pointer to an uint8_t[count] array with the values to
+ *              translate. Only the lower six bits of each value are used.
+ *              A pointer to an uint8_t[64] array storing the lookup table.
+ *     Output:  A pointer to an uint8_t[count] array.
+ *              Array element at index i will contain table[source[i] & 0x3F].
+ *
+ *     The table is split into four rows of 16 elements. Each row is looked
+ *     up with the lower four bits of the values and the row matching the
+ *     upper two bits is selected. Count must be a multiple of 16.
+ */
+void lookupSSE(const uint8_t *source, size_t count,
+               const uint8_t *table, uint8_t *target);
+
+/* Translates 6 bit values with a 16 bit lookup table using SSSE3 extensions
+ *
+ *     Input:   Same as in lookupSSE, except that the lookup table is split
+ *              into two uint8_t[64] arrays storing the lower and the upper
+ *              bytes of the table entries.
+ *     Output:  A pointer to an uint16_t[count] array.
+ */
+void lookup16SSE(const uint8_t *source, size_t count,
+                 const uint8_t *tableLo, const uint8_t *tableHi, uint16_t *target);
+
 #endif
@@ -231,9 +231,13 @@ uint32_t crc32(const uint8_t *addr, size_t size)
 
     uint32_t result = 0;
 
-    // Setup lookup table
-    uint32_t table[256];
-    for(int i = 0; i < 256; i++) table[i] = crc32forByte(i);
+    // Setup lookup table (only once)
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for(int i = 0; i < 256; i++) table[i] = crc32forByte(i);
+        return true;
+    }();
+    (void)initialized;
 
     // Compute CRC-32 checksum
      for(int i = 0; i < size; i++)
@@ -19,6 +19,8 @@
 #include <limits.h>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <sys/param.h>
 #include <time.h>
 #include <mach/mach.h>
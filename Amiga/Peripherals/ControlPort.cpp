@@ -20,8 +20,6 @@ ControlPort::ControlPort(int nr, Amiga& ref) : AmigaComponent(ref)
 void
 ControlPort::_inspect()
 {
-    pthread_mutex_lock(&lock);
-
     /* The port pin values are not stored in plain text. We can easily
      * reverse-engineer them out of the JOYDAT register value though.
      */
@@ -39,7 +37,7 @@ ControlPort::_inspect()
     info.potx = 0; // TODO
     info.poty = 0; // TODO
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -53,13 +51,7 @@ ControlPort::_dump()
 ControlPortInfo
 ControlPort::getInfo()
 {
-    ControlPortInfo result;
-
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-
-    return result;
+    return infoBuffer.read();
 }
 
 uint16_t
@@ -17,6 +17,9 @@ class ControlPort : public AmigaComponent {
     // Information shown in the GUI inspector panel
     ControlPortInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<ControlPortInfo> infoBuffer;
+
     // Represented control port (1 or 2)
     int nr;
     
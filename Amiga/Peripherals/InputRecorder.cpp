@@ -0,0 +1,376 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#include "Amiga.h"
+
+InputRecorder::InputRecorder(Amiga& ref) : AmigaComponent(ref)
+{
+    setDescription("InputRecorder");
+
+    state.store(REC_IDLE);
+    capturePending.store(false);
+}
+
+void
+InputRecorder::_reset()
+{
+    /* A reset clears the event table and the master clock. Hence, a running
+     * recording or replay can't be continued.
+     */
+    if (getState() != REC_IDLE) {
+        debug("Reset: Stopping %s\n", isRecording() ? "recording" : "replay");
+    }
+    state.store(REC_IDLE);
+
+    pthread_mutex_lock(&lock);
+    captured.clear();
+    capturePending.store(false);
+    pthread_mutex_unlock(&lock);
+
+    scheduled.clear();
+}
+
+void
+InputRecorder::_dump()
+{
+    RecorderState s = getState();
+
+    plainmsg("         State: %s\n",
+             s == REC_RECORDING ? "Recording" :
+             s == REC_REPLAYING ? "Replaying" : "Idle");
+    plainmsg("   Start cycle: %lld\n", startCycle);
+    plainmsg("        Events: %zu\n", events.size());
+    plainmsg("Replay pointer: %zu\n", replayPos);
+    plainmsg("     Scheduled: %zu\n", scheduled.size());
+}
+
+void
+InputRecorder::startRecording()
+{
+    amiga.suspend();
+
+    events.clear();
+    scheduled.clear();
+    startCycle = agnus.clock;
+    state.store(REC_RECORDING);
+
+    debug("Recording started at cycle %lld\n", startCycle);
+
+    amiga.resume();
+}
+
+bool
+InputRecorder::startReplay()
+{
+    if (events.empty()) return false;
+
+    amiga.suspend();
+
+    scheduled.clear();
+    replayPos = 0;
+    startCycle = agnus.clock;
+    state.store(REC_REPLAYING);
+    agnus.scheduleAbs<INP_SLOT>(startCycle + events[0].cycle, INP_INJECT);
+
+    debug("Replay of %zu events started at cycle %lld\n", events.size(), startCycle);
+
+    amiga.resume();
+    return true;
+}
+
+void
+InputRecorder::stop()
+{
+    amiga.suspend();
+
+    state.store(REC_IDLE);
+    agnus.cancel<INP_SLOT>();
+
+    pthread_mutex_lock(&lock);
+    captured.clear();
+    capturePending.store(false);
+    pthread_mutex_unlock(&lock);
+
+    // Pass all events to the devices that haven't been processed yet
+    for (auto &e : scheduled) apply(e);
+    scheduled.clear();
+
+    amiga.resume();
+}
+
+bool
+InputRecorder::capture(InputEventType type, int64_t data1, int64_t data2)
+{
+    assert(isInputEventType(type));
+
+    switch (getState()) {
+
+        case REC_IDLE:
+
+            // Let the device process the event as usual
+            return false;
+
+        case REC_RECORDING:
+
+            pthread_mutex_lock(&lock);
+            captured.push_back(InputEvent { 0, type, data1, data2 });
+            capturePending.store(true, std::memory_order_release);
+            pthread_mutex_unlock(&lock);
+            return true;
+
+        case REC_REPLAYING:
+
+            // Ignore live input
+            return true;
+    }
+
+    return false;
+}
+
+void
+InputRecorder::scheduleCaptured()
+{
+    pthread_mutex_lock(&lock);
+    scheduled.insert(scheduled.end(), captured.begin(), captured.end());
+    captured.clear();
+    capturePending.store(false);
+    pthread_mutex_unlock(&lock);
+
+    if (isRecording() && !scheduled.empty()) {
+        agnus.scheduleRel<INP_SLOT>(DMA_CYCLES(1), INP_INJECT);
+    } else {
+        scheduled.clear();
+    }
+}
+
+void
+InputRecorder::serviceInputEvent()
+{
+    assert(agnus.slot[INP_SLOT].id == INP_INJECT);
+
+    Cycle now = agnus.clock;
+
+    switch (getState()) {
+
+        case REC_RECORDING:
+
+            // Pass the scheduled events to the devices and record them
+            for (auto &e : scheduled) {
+
+                e.cycle = now - startCycle;
+                apply(e);
+                events.push_back(e);
+            }
+            scheduled.clear();
+            agnus.cancel<INP_SLOT>();
+            break;
+
+        case REC_REPLAYING:
+
+            // Pass all due events to the devices
+            while (replayPos < events.size() &&
+                   startCycle + events[replayPos].cycle <= now) {
+                apply(events[replayPos++]);
+            }
+
+            // Schedule the next event or finish the replay
+            if (replayPos < events.size()) {
+                agnus.scheduleAbs<INP_SLOT>(startCycle + events[replayPos].cycle, INP_INJECT);
+            } else {
+                debug("Replay finished at cycle %lld\n", now);
+                state.store(REC_IDLE);
+                agnus.cancel<INP_SLOT>();
+                amiga.putMessage(MSG_REPLAY_END);
+            }
+            break;
+
+        default:
+
+            agnus.cancel<INP_SLOT>();
+            break;
+    }
+}
+
+void
+InputRecorder::apply(const InputEvent &e)
+{
+    switch (e.type) {
+
+        case INPUT_KEY_PRESS:       keyboard._pressKey(e.data1); break;
+        case INPUT_KEY_RELEASE:     keyboard._releaseKey(e.data1); break;
+        case INPUT_KEY_RELEASE_ALL: keyboard._releaseAllKeys(); break;
+        case INPUT_MOUSE_XY:        mouse._setXY(e.data1, e.data2); break;
+        case INPUT_MOUSE_LEFT:      mouse._setLeftButton(e.data1); break;
+        case INPUT_MOUSE_RIGHT:     mouse._setRightButton(e.data1); break;
+        case INPUT_MOUSE_ACTION:    mouse._trigger((GamePadAction)e.data1); break;
+        case INPUT_JOY1_ACTION:     joystick1._trigger((GamePadAction)e.data1); break;
+        case INPUT_JOY2_ACTION:     joystick2._trigger((GamePadAction)e.data1); break;
+
+        default:
+            assert(false);
+    }
+}
+
+int
+InputRecorder::dataItems(InputEventType type)
+{
+    switch (type) {
+
+        case INPUT_KEY_RELEASE_ALL: return 0;
+        case INPUT_MOUSE_XY:        return 2;
+        default:                    return 1;
+    }
+}
+
+static void
+putVarInt(vector<uint8_t> &buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((uint8_t)value);
+}
+
+static bool
+getVarInt(const uint8_t *&ptr, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+
+        if (ptr == end) return false;
+
+        uint8_t byte = *ptr++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+static int64_t unzigzag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+vector<uint8_t>
+InputRecorder::encode()
+{
+    vector<uint8_t> result = { 'V', 'A', 'I', 'R', formatVersion };
+    Cycle previous = 0;
+
+    putVarInt(result, events.size());
+
+    for (auto &e : events) {
+
+        putVarInt(result, (uint64_t)(e.cycle - previous));
+        result.push_back((uint8_t)e.type);
+
+        int items = dataItems(e.type);
+        if (items > 0) putVarInt(result, zigzag(e.data1));
+        if (items > 1) putVarInt(result, zigzag(e.data2));
+
+        previous = e.cycle;
+    }
+
+    return result;
+}
+
+bool
+InputRecorder::decode(const uint8_t *buffer, size_t length)
+{
+    const uint8_t *ptr = buffer, *end = buffer + length;
+    vector<InputEvent> result;
+    uint64_t count, value;
+    Cycle cycle = 0;
+
+    // Check the header
+    if (length < 5 || memcmp(buffer, "VAIR", 4) != 0) {
+        warn("Not an input recording\n");
+        return false;
+    }
+    if (buffer[4] != formatVersion) {
+        warn("Unsupported input recording version %d\n", buffer[4]);
+        return false;
+    }
+    ptr += 5;
+
+    if (!getVarInt(ptr, end, count)) goto corrupted;
+
+    for (uint64_t i = 0; i < count; i++) {
+
+        InputEvent e = { 0, INPUT_KEY_PRESS, 0, 0 };
+
+        if (!getVarInt(ptr, end, value)) goto corrupted;
+        cycle += (Cycle)value;
+        e.cycle = cycle;
+
+        if (ptr == end || !isInputEventType(*ptr)) goto corrupted;
+        e.type = (InputEventType)*ptr++;
+
+        int items = dataItems(e.type);
+        if (items > 0) {
+            if (!getVarInt(ptr, end, value)) goto corrupted;
+            e.data1 = unzigzag(value);
+        }
+        if (items > 1) {
+            if (!getVarInt(ptr, end, value)) goto corrupted;
+            e.data2 = unzigzag(value);
+        }
+
+        result.push_back(e);
+    }
+
+    amiga.suspend();
+    events = result;
+    amiga.resume();
+
+    return true;
+
+corrupted:
+
+    warn("Input recording is corrupted\n");
+    return false;
+}
+
+bool
+InputRecorder::writeToFile(const char *path)
+{
+    vector<uint8_t> data = encode();
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        warn("Can't open %s\n", path);
+        return false;
+    }
+
+    bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+
+    if (!success) warn("Failed to write %s\n", path);
+    return success;
+}
+
+bool
+InputRecorder::readFromFile(const char *path)
+{
+    vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t count;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        warn("Can't open %s\n", path);
+        return false;
+    }
+
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + count);
+    }
+    fclose(file);
+
+    return decode(data.data(), data.size());
+}
@@ -0,0 +1,182 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#ifndef _INPUT_RECORDER_INC
+#define _INPUT_RECORDER_INC
+
+#include "AmigaComponent.h"
+
+/* Deterministic recording and replaying of user input
+ *
+ * Normally, keyboard, mouse, and joystick events are passed to the emulated
+ * devices at the time they arrive from the GUI. Because the GUI runs in a
+ * different thread, the events hit the emulator at random cycles and a
+ * session can't be reproduced.
+ *
+ * While a recording is in progress, the devices hand all incoming events
+ * over to the input recorder which collects them in a queue. At the next
+ * HSYNC, the emulator thread moves the queued events into the INP slot. When
+ * the slot triggers, the events are passed to the devices and recorded
+ * together with their trigger cycle (measured relative to the start of the
+ * recording). When a recording is replayed, the events are injected via the
+ * INP slot at exactly the same relative cycles. Hence, replaying a recording
+ * from the same initial state (e.g., after a hard reset or after restoring a
+ * snapshot) reproduces the original session frame by frame. Live input is
+ * ignored during a replay.
+ *
+ * A recording can be exported in a compact binary format:
+ *
+ *     Header: 'V' 'A' 'I' 'R' <version> <event count>
+ *     Event:  <delta cycles> <type> <data 1> ... <data n>
+ *
+ * All numbers except the type and version bytes are stored as variable
+ * length integers (7 bits per byte, least significant group first). The
+ * delta is measured in master cycles relative to the previous event. The
+ * number of data items depends on the event type. Signed data items are
+ * zigzag-encoded.
+ */
+class InputRecorder : public AmigaComponent {
+
+    // Version number of the binary format
+    static const uint8_t formatVersion = 1;
+
+public:
+
+    // A single input event
+    struct InputEvent {
+
+        // Trigger cycle relative to the start of the recording
+        Cycle cycle;
+
+        // Event type and parameters
+        InputEventType type;
+        int64_t data1;
+        int64_t data2;
+    };
+
+private:
+
+    // The current state (written by the GUI thread with the emulator halted)
+    std::atomic<RecorderState> state;
+
+    // Master cycle at which the recording or the replay has been started
+    Cycle startCycle = 0;
+
+    // The recorded events
+    vector<InputEvent> events;
+
+    // Index of the next event to replay
+    size_t replayPos = 0;
+
+    // Events that have been captured from the GUI (guarded by 'lock')
+    vector<InputEvent> captured;
+
+    // Indicates if 'captured' contains elements
+    std::atomic<bool> capturePending;
+
+    // Events that are passed to the devices when the INP slot triggers
+    vector<InputEvent> scheduled;
+
+
+    //
+    // Constructing and destructing
+    //
+
+public:
+
+    InputRecorder(Amiga& ref);
+
+
+    //
+    // Methods from HardwareComponent
+    //
+
+private:
+
+    void _reset() override;
+    void _dump() override;
+    size_t _size() override { return 0; }
+    size_t _load(uint8_t *buffer) override { return 0; }
+    size_t _save(uint8_t *buffer) override { return 0; }
+
+
+    //
+    // Recording and replaying
+    //
+
+public:
+
+    RecorderState getState() { return state.load(); }
+    bool isRecording() { return getState() == REC_RECORDING; }
+    bool isReplaying() { return getState() == REC_REPLAYING; }
+
+    // Returns the number of recorded events
+    size_t eventCount() { return events.size(); }
+
+    // Starts a new recording (previously recorded events are discarded)
+    void startRecording();
+
+    // Starts to replay the current recording (returns false if empty)
+    bool startReplay();
+
+    // Stops recording or replaying
+    void stop();
+
+
+    //
+    // Capturing input
+    //
+
+    /* Hands an input event over to the recorder
+     * This function is called by the input devices when they receive an event
+     * from the GUI. If the function returns true, the recorder has taken care
+     * of the event and the device must not process it.
+     */
+    bool capture(InputEventType type, int64_t data1 = 0, int64_t data2 = 0);
+
+    // Moves the captured events into the INP slot (called in each HSYNC)
+    void hsyncHandler() { if (capturePending.load(std::memory_order_acquire)) scheduleCaptured(); }
+
+    // Services an event in the INP slot
+    void serviceInputEvent();
+
+private:
+
+    // Schedules all captured events
+    void scheduleCaptured();
+
+    // Passes an input event to the emulated devices
+    void apply(const InputEvent &event);
+
+
+    //
+    // Importing and exporting
+    //
+
+public:
+
+    // Encodes the recording in the binary format
+    vector<uint8_t> encode();
+
+    // Replaces the recording by a decoded one (returns false on errors)
+    bool decode(const uint8_t *buffer, size_t length);
+
+    // Saves the recording to a file
+    bool writeToFile(const char *path);
+
+    // Loads a recording from a file
+    bool readFromFile(const char *path);
+
+private:
+
+    // Returns the number of data items of a certain event type
+    static int dataItems(InputEventType type);
+};
+
+#endif
@@ -0,0 +1,46 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+// This file must conform to standard ANSI-C to be compatible with Swift.
+
+#ifndef _INPUT_RECORDER_T_INC
+#define _INPUT_RECORDER_T_INC
+
+//
+// Enumerations
+//
+
+typedef enum : long
+{
+    INPUT_KEY_PRESS,        // Press a key (data = keycode)
+    INPUT_KEY_RELEASE,      // Release a key (data = keycode)
+    INPUT_KEY_RELEASE_ALL,  // Release all keys
+    INPUT_MOUSE_XY,         // Move the mouse (data = x, y)
+    INPUT_MOUSE_LEFT,       // Set the left mouse button (data = value)
+    INPUT_MOUSE_RIGHT,      // Set the right mouse button (data = value)
+    INPUT_MOUSE_ACTION,     // Trigger a mouse action (data = GamePadAction)
+    INPUT_JOY1_ACTION,      // Trigger a joystick action (data = GamePadAction)
+    INPUT_JOY2_ACTION,      // Trigger a joystick action (data = GamePadAction)
+    INPUT_EVENT_COUNT
+}
+InputEventType;
+
+static inline bool isInputEventType(long value) {
+    return value >= 0 && value < INPUT_EVENT_COUNT;
+}
+
+typedef enum : long
+{
+    REC_IDLE,               // Input is passed through to the devices
+    REC_RECORDING,          // Input is time-stamped and recorded
+    REC_REPLAYING           // Input is taken from the recording
+}
+RecorderState;
+
+#endif
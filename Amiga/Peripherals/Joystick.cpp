@@ -107,6 +107,15 @@ Joystick::trigger(GamePadAction event)
 {
     assert(isGamePadAction(event));
 
+    InputEventType type = nr == 1 ? INPUT_JOY1_ACTION : INPUT_JOY2_ACTION;
+    if (!amiga.inputRecorder.capture(type, event)) _trigger(event);
+}
+
+void
+Joystick::_trigger(GamePadAction event)
+{
+    assert(isGamePadAction(event));
+
     debug(PORT_DEBUG, "trigger(%d)\n", event);
      
     switch (event) {
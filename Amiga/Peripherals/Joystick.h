@@ -14,6 +14,8 @@
 
 class Joystick : public AmigaComponent {
 
+    friend class InputRecorder;
+
     // The control port this joystick is connected to (1 or 2)
     int nr;
     
@@ -119,6 +121,13 @@ public:
     // Triggers a gamepad event
     void trigger(GamePadAction event);
 
+private:
+
+    // Counterpart of trigger() that bypasses the input recorder
+    void _trigger(GamePadAction event);
+
+public:
+
     /* Execution function for this control port
      * This method needs to be invoked at the end of each frame to make the
      * auto-fire mechanism work.
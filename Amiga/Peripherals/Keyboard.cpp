@@ -44,6 +44,14 @@ Keyboard::pressKey(long keycode)
 {
     assert(keycode < 0x80);
 
+    if (!amiga.inputRecorder.capture(INPUT_KEY_PRESS, keycode)) _pressKey(keycode);
+}
+
+void
+Keyboard::_pressKey(long keycode)
+{
+    assert(keycode < 0x80);
+
     if (!keyDown[keycode] && !bufferIsFull()) {
 
         debug(KBD_DEBUG, "Pressing Amiga key %02X\n", keycode);
@@ -58,6 +66,14 @@ Keyboard::releaseKey(long keycode)
 {
     assert(keycode < 0x80);
 
+    if (!amiga.inputRecorder.capture(INPUT_KEY_RELEASE, keycode)) _releaseKey(keycode);
+}
+
+void
+Keyboard::_releaseKey(long keycode)
+{
+    assert(keycode < 0x80);
+
     if (keyDown[keycode] && !bufferIsFull()) {
 
         debug(KBD_DEBUG, "Releasing Amiga key %02X\n", keycode);
@@ -69,9 +85,15 @@ Keyboard::releaseKey(long keycode)
 
 void
 Keyboard::releaseAllKeys()
+{
+    if (!amiga.inputRecorder.capture(INPUT_KEY_RELEASE_ALL)) _releaseAllKeys();
+}
+
+void
+Keyboard::_releaseAllKeys()
 {
     for (unsigned i = 0; i < 0x80; i++) {
-        releaseKey(i);
+        _releaseKey(i);
     }
 }
 
@@ -14,6 +14,8 @@
 
 class Keyboard : public AmigaComponent {
 
+    friend class InputRecorder;
+
     // The current configuration
      KeyboardConfig config;
 
@@ -102,11 +104,20 @@ private:
     
 public:
 
+    /* The following functions are called by the GUI. If an input recording
+     * is in progress, the events are rerouted through the input recorder.
+     */
     bool keyIsPressed(long keycode);
     void pressKey(long keycode);
     void releaseKey(long keycode);
     void releaseAllKeys();
 
+private:
+
+    void _pressKey(long keycode);
+    void _releaseKey(long keycode);
+    void _releaseAllKeys();
+
 
     //
     // Managing the type-ahead buffer
@@ -84,6 +84,12 @@ Mouse::getXY()
 
 void
 Mouse::setXY(int64_t x, int64_t y)
+{
+    if (!amiga.inputRecorder.capture(INPUT_MOUSE_XY, x, y)) _setXY(x, y);
+}
+
+void
+Mouse::_setXY(int64_t x, int64_t y)
 {
     // debug("setXY(%lld,%lld)\n", x, y);
     
@@ -95,6 +101,12 @@ Mouse::setXY(int64_t x, int64_t y)
 
 void
 Mouse::setLeftButton(bool value)
+{
+    if (!amiga.inputRecorder.capture(INPUT_MOUSE_LEFT, value)) _setLeftButton(value);
+}
+
+void
+Mouse::_setLeftButton(bool value)
 {
     debug(PORT_DEBUG, "setLeftButton(%d)\n", value);
     leftButton = value;
@@ -102,6 +114,12 @@ Mouse::setLeftButton(bool value)
 
 void
 Mouse::setRightButton(bool value)
+{
+    if (!amiga.inputRecorder.capture(INPUT_MOUSE_RIGHT, value)) _setRightButton(value);
+}
+
+void
+Mouse::_setRightButton(bool value)
 {
     debug(PORT_DEBUG, "setRightButton(%d)\n", value);
     rightButton = value;
@@ -112,14 +130,22 @@ Mouse::trigger(GamePadAction event)
 {
     assert(isGamePadAction(event));
 
+    if (!amiga.inputRecorder.capture(INPUT_MOUSE_ACTION, event)) _trigger(event);
+}
+
+void
+Mouse::_trigger(GamePadAction event)
+{
+    assert(isGamePadAction(event));
+
     debug(PORT_DEBUG, "trigger(%d)\n", event);
 
     switch (event) {
 
-        case PRESS_LEFT: setLeftButton(true); break;
-        case RELEASE_LEFT: setLeftButton(false); break;
-        case PRESS_RIGHT: setRightButton(true); break;
-        case RELEASE_RIGHT: setRightButton(false); break;
+        case PRESS_LEFT: _setLeftButton(true); break;
+        case RELEASE_LEFT: _setLeftButton(false); break;
+        case PRESS_RIGHT: _setRightButton(true); break;
+        case RELEASE_RIGHT: _setRightButton(false); break;
         default: break;
     }
 }
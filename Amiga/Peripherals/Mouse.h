@@ -13,7 +13,9 @@
 #include "AmigaComponent.h"
 
 class Mouse : public AmigaComponent {
-    
+
+    friend class InputRecorder;
+
 public:
     
     // Mouse button states
@@ -112,6 +114,14 @@ public:
 
     // Performs periodic actions for this device
     void execute();
+
+private:
+
+    // Counterparts of the functions above that bypass the input recorder
+    void _setXY(int64_t x, int64_t y);
+    void _setLeftButton(bool value);
+    void _setRightButton(bool value);
+    void _trigger(GamePadAction event);
 };
 
 #endif
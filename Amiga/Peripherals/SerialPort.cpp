@@ -34,8 +34,6 @@ SerialPort::_reset()
 void
 SerialPort::_inspect()
 {
-    pthread_mutex_lock(&lock);
-
     info.port = port; 
     info.txd = getTXD();
     info.rxd = getRXD();
@@ -45,7 +43,7 @@ SerialPort::_inspect()
     info.cd = getCD();
     info.dtr = getDTR();
 
-    pthread_mutex_unlock(&lock);
+    infoBuffer.write(info);
 }
 
 void
@@ -58,13 +56,7 @@ SerialPort::_dump()
 SerialPortInfo
 SerialPort::getInfo()
 {
-    SerialPortInfo result;
-
-    pthread_mutex_lock(&lock);
-    result = info;
-    pthread_mutex_unlock(&lock);
-
-    return result;
+    return infoBuffer.read();
 }
 
 bool
@@ -29,6 +29,9 @@ class SerialPort : public AmigaComponent {
     // Information shown in the GUI inspector panel
     SerialPortInfo info;
 
+    // The most recently published version of 'info'
+    InfoBuffer<SerialPortInfo> infoBuffer;
+
 
     //
     // Variables
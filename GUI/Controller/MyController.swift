@@ -708,7 +708,10 @@ extension MyController {
              MSG_USERSNAPSHOT_SAVED:
             renderer.blendIn(steps: 20)
 
-        case MSG_AUTOSNAPSHOT_SAVED:
+        case MSG_AUTOSNAPSHOT_SAVED,
+             MSG_REPLAY_END,
+             MSG_SCRIPT_DONE,
+             MSG_SCRIPT_ABORT:
             break
 
         case MSG_ROM_MISSING:
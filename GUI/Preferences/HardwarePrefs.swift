@@ -30,7 +30,7 @@ extension PreferencesController {
         // Memory
         hwChipRamPopup.selectItem(withTag: config.mem.chipSize / 1024)
         hwSlowRamPopup.selectItem(withTag: config.mem.slowSize / 1024)
-        hwFastRamPopup.selectItem(withTag: config.mem.fastSize / 1024)
+        hwFastRamPopup.selectItem(withTag: config.zorro.boardSize.0 / 1024)
 
         // Drive
         hwDf1Connect.state = config.diskController.connected.1 ? .on : .off
@@ -118,6 +118,7 @@ struct AmigaFileWrapper;
 
 - (AmigaInfo) getInfo;
 - (AmigaStats) getStats;
+- (FrameCounters) getFrameCounters;
 
 // - (BOOL) readyToPowerUp;
 - (BOOL) isPoweredOn;
@@ -135,6 +136,7 @@ struct AmigaFileWrapper;
 - (BOOL) configure:(ConfigOption)option enable:(BOOL)value;
 - (BOOL) configureDrive:(NSInteger)nr connected:(BOOL)value;
 - (BOOL) configureDrive:(NSInteger)nr type:(NSInteger)value;
+- (BOOL) configureBoard:(NSInteger)nr fastRam:(NSInteger)value;
 
 // Message queue
 - (void) addListener:(const void *)sender function:(Callback *)func;
@@ -180,6 +182,24 @@ struct AmigaFileWrapper;
 - (void) deleteAutoSnapshot:(NSInteger)nr;
 - (void) deleteUserSnapshot:(NSInteger)nr;
 
+// Recording and replaying user input
+- (RecorderState) recorderState;
+- (void) startRecording;
+- (BOOL) startReplay;
+- (void) stopRecorder;
+- (BOOL) saveRecording:(NSURL *)url;
+- (BOOL) loadRecording:(NSURL *)url;
+
+// Running scripts
+- (BOOL) loadScript:(NSURL *)url;
+- (void) startScript;
+- (void) stopScript;
+- (BOOL) scriptIsActive;
+
+- (BOOL) attachBlockDevice:(NSURL *)url;
+- (void) detachBlockDevice;
+- (BOOL) blockDeviceIsAttached;
+
 @end
 
 
@@ -341,6 +361,9 @@ struct AmigaFileWrapper;
 - (void) dmaDebugSetColor:(BusOwner)owner r:(double)r g:(double)g b:(double)b;
 - (void) dmaDebugSetOpacity:(double)value;
 - (void) dmaDebugSetDisplayMode:(NSInteger)mode;
+- (BOOL) dmaDebugStartTrace:(NSURL *)url;
+- (void) dmaDebugStopTrace;
+- (BOOL) dmaDebugIsTracing;
 
 @end
 
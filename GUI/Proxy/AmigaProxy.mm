@@ -482,6 +482,18 @@ struct ADFFileWrapper { ADFFile *adf; };
 {
     wrapper->agnus->dmaDebugger.setDisplayMode((DmaDebuggerDisplayMode)mode);
 }
+- (BOOL) dmaDebugStartTrace:(NSURL *)url
+{
+    return wrapper->agnus->dmaDebugger.startTrace([[url path] UTF8String]);
+}
+- (void) dmaDebugStopTrace
+{
+    wrapper->agnus->dmaDebugger.stopTrace();
+}
+- (BOOL) dmaDebugIsTracing
+{
+    return wrapper->agnus->dmaDebugger.isTracing();
+}
 
 @end
 
@@ -1354,6 +1366,12 @@ struct ADFFileWrapper { ADFFile *adf; };
 {
    return wrapper->amiga->getStats();
 }
+- (FrameCounters) getFrameCounters
+{
+    FrameCounters result = { };
+    wrapper->amiga->getLatestFrameCounters(result);
+    return result;
+}
 /*
 - (BOOL) readyToPowerUp
 {
@@ -1413,6 +1431,10 @@ struct ADFFileWrapper { ADFFile *adf; };
 {
     return wrapper->amiga->configureDrive(nr, VA_DRIVE_TYPE, type);
 }
+- (BOOL) configureBoard:(NSInteger)nr fastRam:(NSInteger)value
+{
+    return wrapper->amiga->configureBoard(nr, VA_FAST_RAM, value);
+}
 - (void) addListener:(const void *)sender function:(Callback *)func
 {
     wrapper->amiga->addListener(sender, func);
@@ -1551,5 +1573,59 @@ struct ADFFileWrapper { ADFFile *adf; };
     wrapper->amiga->deleteUserSnapshot((unsigned)nr);
 }
 
+- (RecorderState) recorderState
+{
+    return wrapper->amiga->inputRecorder.getState();
+}
+- (void) startRecording
+{
+    wrapper->amiga->inputRecorder.startRecording();
+}
+- (BOOL) startReplay
+{
+    return wrapper->amiga->inputRecorder.startReplay();
+}
+- (void) stopRecorder
+{
+    wrapper->amiga->inputRecorder.stop();
+}
+- (BOOL) saveRecording:(NSURL *)url
+{
+    return wrapper->amiga->inputRecorder.writeToFile([[url path] UTF8String]);
+}
+- (BOOL) loadRecording:(NSURL *)url
+{
+    return wrapper->amiga->inputRecorder.readFromFile([[url path] UTF8String]);
+}
+
+- (BOOL) loadScript:(NSURL *)url
+{
+    return wrapper->amiga->automator.loadScript([[url path] UTF8String]);
+}
+- (void) startScript
+{
+    wrapper->amiga->automator.start();
+}
+- (void) stopScript
+{
+    wrapper->amiga->automator.stop();
+}
+- (BOOL) scriptIsActive
+{
+    return wrapper->amiga->automator.isActive();
+}
+- (BOOL) attachBlockDevice:(NSURL *)url
+{
+    return wrapper->amiga->zorro.blockDevice.attach([[url path] UTF8String]);
+}
+- (void) detachBlockDevice
+{
+    wrapper->amiga->zorro.blockDevice.detach();
+}
+- (BOOL) blockDeviceIsAttached
+{
+    return wrapper->amiga->zorro.blockDevice.isAttached();
+}
+
 @end
 
@@ -944,7 +944,7 @@ extension MyController {
 
         defaults.set(config.mem.chipSize / 1024, forKey: Keys.chipRam)
         defaults.set(config.mem.slowSize / 1024, forKey: Keys.slowRam)
-        defaults.set(config.mem.fastSize / 1024, forKey: Keys.fastRam)
+        defaults.set(config.zorro.boardSize.0 / 1024, forKey: Keys.fastRam)
 
         defaults.set(config.df0.speed, forKey: Keys.driveSpeed)
         defaults.set(dc.connected.0, forKey: Keys.df0Connect)
@@ -974,9 +974,11 @@ extension Keys {
     // Audio
     static let filterActivation  = "VAMIGAFilterActivation"
     static let filterType        = "VAMIGAFilterType"
+    static let bandLimiting      = "VAMIGABandLimiting"
 
     // Blitter
     static let blitterAccuracy   = "VAMIGABlitterAccuracy"
+    static let blitterHybrid     = "VAMIGABlitterHybrid"
 
     // Floppy drives
     static let driveSpeed        = "VAMIGADriveSpeedKey"
@@ -993,9 +995,11 @@ extension Defaults {
     // Audio
     static let filterActivation  = FILTACT_POWER_LED
     static let filterType        = FILT_BUTTERWORTH
+    static let bandLimiting      = false
 
     // Blitter
     static let blitterAccuracy   = 0
+    static let blitterHybrid     = false
 
     // Floppy drives
     static let driveSpeed        = 1
@@ -1013,7 +1017,9 @@ extension MyController {
             Keys.clxPlfPlf: Defaults.clxPlfPlf,
             Keys.filterActivation: Defaults.filterActivation.rawValue,
             Keys.filterType: Defaults.filterType.rawValue,
+            Keys.bandLimiting: Defaults.bandLimiting,
             Keys.blitterAccuracy: Defaults.blitterAccuracy,
+            Keys.blitterHybrid: Defaults.blitterHybrid,
             Keys.driveSpeed: Defaults.driveSpeed,
             Keys.fifoBuffering: Defaults.fifoBuffering
         ]
@@ -1031,7 +1037,9 @@ extension MyController {
                      Keys.clxPlfPlf,
                      Keys.filterActivation,
                      Keys.filterType,
+                     Keys.bandLimiting,
                      Keys.blitterAccuracy,
+                     Keys.blitterHybrid,
                      Keys.driveSpeed,
                      Keys.fifoBuffering ]
 
@@ -1051,7 +1059,9 @@ extension MyController {
         amiga.configure(VA_CLX_PLF_PLF, enable: defaults.bool(forKey: Keys.clxPlfPlf))
         amiga.configure(VA_FILTER_ACTIVATION, value: defaults.integer(forKey: Keys.filterActivation))
         amiga.configure(VA_FILTER_TYPE, value: defaults.integer(forKey: Keys.filterType))
+        amiga.configure(VA_BAND_LIMITING, enable: defaults.bool(forKey: Keys.bandLimiting))
         amiga.configure(VA_BLITTER_ACCURACY, value: defaults.integer(forKey: Keys.blitterAccuracy))
+        amiga.configure(VA_BLITTER_HYBRID, enable: defaults.bool(forKey: Keys.blitterHybrid))
         amiga.configure(VA_DRIVE_SPEED, value: defaults.integer(forKey: Keys.driveSpeed))
         amiga.configure(VA_FIFO_BUFFERING, enable: defaults.bool(forKey: Keys.fifoBuffering))
 
@@ -1068,7 +1078,9 @@ extension MyController {
         defaults.set(config.denise.clxPlfPlf, forKey: Keys.clxPlfPlf)
         defaults.set(config.audio.filterActivation.rawValue, forKey: Keys.filterActivation)
         defaults.set(config.audio.filterType.rawValue, forKey: Keys.filterType)
+        defaults.set(config.audio.bandLimiting, forKey: Keys.bandLimiting)
         defaults.set(config.blitter.accuracy, forKey: Keys.blitterAccuracy)
+        defaults.set(config.blitter.hybrid, forKey: Keys.blitterHybrid)
         defaults.set(config.diskController.useFifo, forKey: Keys.fifoBuffering)
     }
 }
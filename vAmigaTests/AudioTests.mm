@@ -0,0 +1,221 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "Amiga.h"
+
+#include <vector>
+
+// Collects the samples of the left channel
+class CaptureSink : public AudioSink {
+
+public:
+
+    std::vector<float> samples;
+
+    void consume(const float *left, const float *right, size_t n) override {
+        samples.insert(samples.end(), left, left + n);
+    }
+};
+
+// Creates an Amiga with 512 KB Chip Ram and an unfiltered audio output
+static Amiga *
+makeAmiga(bool bandLimiting)
+{
+    Amiga *amiga = new Amiga();
+
+    amiga->configure(VA_CHIP_RAM, 512);
+    amiga->configure(VA_FILTER_ACTIVATION, FILTACT_NEVER);
+    amiga->configure(VA_BAND_LIMITING, bandLimiting);
+    amiga->paula.audioUnit.setSampleRate(44100);
+    amiga->paula.audioUnit.setOffline(true);
+
+    return amiga;
+}
+
+// Returns the master clock cycle at which the n-th sample is produced
+static Cycle
+sampleCycle(Amiga *amiga, size_t n)
+{
+    double dmaCyclesPerSample = MHz(dmaClockFrequency) / amiga->paula.audioUnit.getSampleRate();
+    return DMA_CYCLES((Cycle)ceil(n * dmaCyclesPerSample));
+}
+
+/* Plays a sample consisting of a single repeated byte on channel 0.
+ * The channel output changes once, when the first byte is put out, and
+ * stays constant afterwards.
+ */
+static std::vector<float>
+renderStep(Amiga *amiga, size_t n)
+{
+    AudioUnit &audio = amiga->paula.audioUnit;
+    CaptureSink sink;
+
+    memset(amiga->mem.chip + 0x1000, 0x40, 0x100);
+
+    audio.channel0.pokeAUDxLCH(0x0000);
+    audio.channel0.pokeAUDxLCL(0x1000);
+    audio.channel0.pokeAUDxLEN(0x80);
+    audio.channel0.pokeAUDxPER(200);
+    audio.channel0.pokeAUDxVOL(64);
+
+    audio.addSink(&sink);
+    amiga->agnus.setDMACON(0, 0x8000 | DMAEN | AU0EN);
+    audio.executeUntil(sampleCycle(amiga, n + 1));
+    audio.removeSink(&sink);
+
+    sink.samples.resize(n);
+    return sink.samples;
+}
+
+/* Computes the band-limited step response for a step at a sample boundary
+ * from the windowed sinc definition of the BLEP kernel.
+ */
+static std::vector<double>
+stepResponse()
+{
+    const int taps = BlepBuffer::taps;
+    const double cutoff = 0.45;
+    const double center = taps / 2 - 1;
+
+    std::vector<double> impulse(taps), response(taps);
+    double sum = 0.0;
+
+    for (int k = 0; k < taps; k++) {
+
+        double x = k - center;
+        double s = x == 0.0 ? 1.0 : sin(M_PI * 2 * cutoff * x) / (M_PI * 2 * cutoff * x);
+        double w = 0.42 + 0.5 * cos(M_PI * x / (taps / 2)) + 0.08 * cos(2 * M_PI * x / (taps / 2));
+
+        impulse[k] = s * w;
+        sum += impulse[k];
+    }
+
+    double level = 0.0;
+    for (int k = 0; k < taps; k++) {
+        level += impulse[k] / sum;
+        response[k] = level;
+    }
+
+    return response;
+}
+
+/* Plays random samples on all four channels.
+ * Each channel loops over 32 KB of noise with a different period.
+ */
+static void
+startNoise(Amiga *amiga)
+{
+    AudioUnit &audio = amiga->paula.audioUnit;
+
+    srand(42);
+    for (uint32_t i = 0x10000; i < 0x30000; i++) amiga->mem.chip[i] = (uint8_t)rand();
+
+    audio.channel0.pokeAUDxLCH(0x0001);
+    audio.channel0.pokeAUDxLCL(0x0000);
+    audio.channel0.pokeAUDxLEN(0x4000);
+    audio.channel0.pokeAUDxPER(124);
+    audio.channel0.pokeAUDxVOL(64);
+
+    audio.channel1.pokeAUDxLCH(0x0001);
+    audio.channel1.pokeAUDxLCL(0x8000);
+    audio.channel1.pokeAUDxLEN(0x4000);
+    audio.channel1.pokeAUDxPER(214);
+    audio.channel1.pokeAUDxVOL(48);
+
+    audio.channel2.pokeAUDxLCH(0x0002);
+    audio.channel2.pokeAUDxLCL(0x0000);
+    audio.channel2.pokeAUDxLEN(0x4000);
+    audio.channel2.pokeAUDxPER(320);
+    audio.channel2.pokeAUDxVOL(32);
+
+    audio.channel3.pokeAUDxLCH(0x0002);
+    audio.channel3.pokeAUDxLCL(0x8000);
+    audio.channel3.pokeAUDxLEN(0x4000);
+    audio.channel3.pokeAUDxPER(428);
+    audio.channel3.pokeAUDxVOL(64);
+
+    amiga->agnus.setDMACON(0, 0x8000 | DMAEN | AU0EN | AU1EN | AU2EN | AU3EN);
+}
+
+@interface AudioTests : XCTestCase
+
+@end
+
+@implementation AudioTests {
+
+    Amiga *amiga;
+    Cycle clock;
+}
+
+- (void)tearDown {
+
+    delete amiga;
+}
+
+// Checks that a single step is rendered as the integral of the BLEP kernel
+- (void)testBandLimitedStep {
+
+    const size_t n = 64;
+
+    // Locate the step in the point-sampled output
+    amiga = makeAmiga(false);
+    std::vector<float> pointSampled = renderStep(amiga, n);
+    delete amiga;
+
+    size_t pos = 0;
+    while (pos < n && pointSampled[pos] == 0.0f) pos++;
+    XCTAssertLessThan(pos + BlepBuffer::taps, n);
+
+    float height = pointSampled[pos];
+    XCTAssertEqual(height, 64.0f * 64.0f / 32768.0f);
+    for (size_t i = pos; i < n; i++) XCTAssertEqual(pointSampled[i], height);
+
+    // The channel changes its output at the very beginning of the interval
+    amiga = makeAmiga(true);
+    std::vector<float> bandLimited = renderStep(amiga, n);
+    std::vector<double> response = stepResponse();
+
+    for (size_t i = 0; i < n; i++) {
+
+        double expected =
+        i < pos ? 0.0 : i - pos < response.size() ? height * response[i - pos] : height;
+        XCTAssertEqualWithAccuracy(bandLimited[i], expected, 1e-6);
+    }
+}
+
+// Measures the time needed to synthesize ten seconds of point-sampled audio
+- (void)testSynthesisPerformance {
+
+    amiga = makeAmiga(false);
+    startNoise(amiga);
+    clock = 0;
+
+    [self measureBlock:^{
+
+        self->clock += sampleCycle(self->amiga, 441000);
+        self->amiga->paula.audioUnit.executeUntil(self->clock);
+    }];
+}
+
+// Measures the time needed to synthesize ten seconds of band-limited audio
+- (void)testBandLimitedSynthesisPerformance {
+
+    amiga = makeAmiga(true);
+    startNoise(amiga);
+    clock = 0;
+
+    [self measureBlock:^{
+
+        self->clock += sampleCycle(self->amiga, 441000);
+        self->amiga->paula.audioUnit.executeUntil(self->clock);
+    }];
+}
+
+@end
@@ -0,0 +1,339 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "Amiga.h"
+
+// The register values of a single line blit
+struct LineBlit {
+
+    uint16_t bltcon0;
+    uint16_t bltcon1;
+    uint16_t bltafwm;
+    uint16_t adat;
+    uint16_t bdat;
+    uint16_t cdat;
+    uint32_t apt;
+    uint32_t cpt;
+    uint32_t dpt;
+    int16_t amod;
+    int16_t bmod;
+    int16_t cmod;
+    uint16_t height;
+};
+
+// The observable results of a line blit
+struct LineResult {
+
+    uint16_t bltcon0;
+    uint16_t bltcon1;
+    uint16_t bltapt;
+    uint16_t bltcpt;
+    uint16_t bltdpt;
+    uint16_t bnew;
+    bool bzero;
+    uint16_t dataBus;
+};
+
+// Creates an Amiga with 512 KB Chip Ram and the Fast Blitter enabled
+static Amiga *
+makeAmiga()
+{
+    Amiga *amiga = new Amiga();
+
+    amiga->configure(VA_CHIP_RAM, 512);
+    amiga->configure(VA_BLITTER_ACCURACY, 0);
+    amiga->agnus.setDMACON(0, 0x8000 | DMAEN | BLTEN);
+
+    return amiga;
+}
+
+// Sets up a line blit from the start and the end point of a line
+static LineBlit
+lineBlit(uint32_t base, int x0, int y0, int x1, int y1)
+{
+    LineBlit blit;
+
+    int dx = x1 - x0, dy = y1 - y0;
+    int dmax = MAX(abs(dx), abs(dy));
+    int dmin = MIN(abs(dx), abs(dy));
+    bool xMajor = abs(dx) >= abs(dy);
+    int octant = xMajor ? 4 | (dy < 0) << 1 | (dx < 0) : (dx < 0) << 1 | (dy < 0);
+    int16_t apt = 4 * dmin - 2 * dmax;
+
+    blit.bltcon0 = (uint16_t)((x0 & 15) << 12 | 0x0BCA);
+    blit.bltcon1 = (uint16_t)(octant << 2 | (apt < 0) << 6 | 1);
+    blit.bltafwm = 0xFFFF;
+    blit.adat = 0x8000;
+    blit.bdat = 0xFFFF;
+    blit.cdat = 0;
+    blit.apt = (uint16_t)apt;
+    blit.cpt = base + y0 * 40 + (x0 >> 4) * 2;
+    blit.dpt = blit.cpt;
+    blit.amod = (int16_t)(4 * (dmin - dmax));
+    blit.bmod = (int16_t)(4 * dmin);
+    blit.cmod = 40;
+    blit.height = (uint16_t)(dmax + 1);
+
+    return blit;
+}
+
+// Runs a line blit through the Blitter's register interface
+static void
+runLineBlit(Amiga *amiga, const LineBlit &blit)
+{
+    Blitter &blitter = amiga->agnus.blitter;
+
+    blitter.pokeBLTCON0(blit.bltcon0);
+    blitter.pokeBLTCON1(blit.bltcon1);
+    blitter.pokeBLTAFWM(blit.bltafwm);
+    blitter.pokeBLTAPTH(HI_WORD(blit.apt));
+    blitter.pokeBLTAPTL(LO_WORD(blit.apt));
+    blitter.pokeBLTCPTH(HI_WORD(blit.cpt));
+    blitter.pokeBLTCPTL(LO_WORD(blit.cpt));
+    blitter.pokeBLTDPTH(HI_WORD(blit.dpt));
+    blitter.pokeBLTDPTL(LO_WORD(blit.dpt));
+    blitter.pokeBLTAMOD(blit.amod);
+    blitter.pokeBLTBMOD(blit.bmod);
+    blitter.pokeBLTCMOD(blit.cmod);
+    blitter.pokeBLTDMOD(blit.cmod);
+    blitter.pokeBLTADAT(blit.adat);
+    blitter.pokeBLTBDAT(blit.bdat);
+    blitter.pokeBLTCDAT(blit.cdat);
+    blitter.setBLTSIZE((uint16_t)(blit.height << 6 | 2));
+
+    blitter.serviceEvent(BLT_STRT1);
+    blitter.serviceEvent(BLT_STRT2);
+}
+
+// Reads back the observable results of the most recent line blit
+static LineResult
+lineResult(Amiga *amiga)
+{
+    Blitter &blitter = amiga->agnus.blitter;
+
+    blitter.inspect();
+    BlitterInfo info = blitter.getInfo();
+
+    return LineResult {
+        info.bltcon0, info.bltcon1, info.bltapt, info.bltcpt, info.bltdpt,
+        info.bnew, blitter.isZero(), amiga->mem.dataBus
+    };
+}
+
+/* Performs a line blit the way doFastLineBlit() did before the word cache
+ * was added. Channel C is read and channel D is written for each pixel.
+ */
+static LineResult
+referenceLineBlit(Amiga *amiga, const LineBlit &blit)
+{
+    Memory &mem = amiga->mem;
+    Blitter &blitter = amiga->agnus.blitter;
+
+    auto incPtr = [&](uint32_t &ptr, int32_t delta) {
+        ptr = (ptr + delta) & mem.chipMask & ~1;
+    };
+
+    uint32_t bltcon = HI_W_LO_W(blit.bltcon0, blit.bltcon1);
+    uint16_t bsh = blit.bltcon1 >> 12;
+
+    uint16_t bltadat_local = 0;
+    uint16_t bltbdat_local = 0;
+    uint16_t bltcdat_local = blit.cdat;
+    uint16_t bltddat_local = 0;
+
+    uint16_t mask = (blit.bdat >> bsh) | (blit.bdat << (16 - bsh));
+    bool a_enabled = bltcon & 0x08000000;
+    bool c_enabled = bltcon & 0x02000000;
+
+    bool decision_is_signed = (((bltcon >> 6) & 1) == 1);
+    uint32_t decision_variable = blit.apt;
+
+    int16_t decision_inc_signed = a_enabled ? blit.bmod : 0;
+    int16_t decision_inc_unsigned = a_enabled ? blit.amod : 0;
+
+    uint32_t bltcpt_local = blit.cpt;
+    uint32_t bltdpt_local = blit.dpt;
+    uint32_t blit_a_shift_local = blit.bltcon0 >> 12;
+    uint32_t bltzero_local = 0;
+
+    uint32_t sulsudaul = (bltcon >> 2) & 0x7;
+    bool x_independent = (sulsudaul & 4);
+    bool x_inc = ((!x_independent) && !(sulsudaul & 2)) || (x_independent && !(sulsudaul & 1));
+    bool y_inc = ((!x_independent) && !(sulsudaul & 1)) || (x_independent && !(sulsudaul & 2));
+    bool single_dot = false;
+    uint8_t minterm = (uint8_t)(bltcon >> 16);
+
+    auto increaseX = [&]() {
+        if (blit_a_shift_local < 15) blit_a_shift_local++;
+        else { blit_a_shift_local = 0; incPtr(bltcpt_local, 2); }
+    };
+    auto decreaseX = [&]() {
+        if (blit_a_shift_local == 0) { blit_a_shift_local = 16; incPtr(bltcpt_local, -2); }
+        blit_a_shift_local--;
+    };
+    auto increaseY = [&]() { incPtr(bltcpt_local, blit.cmod); };
+    auto decreaseY = [&]() { incPtr(bltcpt_local, -blit.cmod); };
+
+    for (unsigned i = 0; i < blit.height; i++) {
+
+        if (c_enabled) bltcdat_local = mem.peek16<BUS_BLITTER>(bltcpt_local);
+
+        bltadat_local = (blit.adat & blit.bltafwm) >> blit_a_shift_local;
+
+        if (x_independent && (bltcon & 0x00000002)) {
+            if (single_dot) bltadat_local = 0; else single_dot = true;
+        }
+
+        bltbdat_local = (mask & 1) ? 0xFFFF : 0;
+        bltddat_local = blitter.doMintermLogic(bltadat_local, bltbdat_local, bltcdat_local, minterm);
+
+        if (c_enabled) mem.poke16<BUS_BLITTER>(bltdpt_local, bltddat_local);
+
+        bltzero_local = bltzero_local | bltddat_local;
+        mask = (mask << 1) | (mask >> 15);
+
+        if (decision_is_signed) {
+            decision_variable += decision_inc_signed;
+        } else {
+            decision_variable += decision_inc_unsigned;
+            if (!x_independent) {
+                if (x_inc) increaseX(); else decreaseX();
+            } else {
+                if (y_inc) increaseY(); else decreaseY();
+                single_dot = false;
+            }
+        }
+        decision_is_signed = ((int16_t)decision_variable < 0);
+
+        if (!x_independent) {
+            if (y_inc) increaseY(); else decreaseY();
+        } else {
+            if (x_inc) increaseX(); else decreaseX();
+        }
+        bltdpt_local = bltcpt_local;
+    }
+
+    return LineResult {
+        (uint16_t)((blit.bltcon0 & 0x0FFF) | blit_a_shift_local << 12),
+        blit.bltcon1,
+        (uint16_t)(decision_variable & mem.chipMask & ~1),
+        (uint16_t)bltcpt_local,
+        (uint16_t)bltdpt_local,
+        bltbdat_local,
+        bltzero_local != 0,
+        mem.dataBus
+    };
+}
+
+@interface BlitterTests : XCTestCase
+@end
+
+@implementation BlitterTests {
+
+    Amiga *amiga;
+    Amiga *reference;
+}
+
+- (void)setUp {
+
+    amiga = makeAmiga();
+    reference = makeAmiga();
+}
+
+- (void)tearDown {
+
+    delete amiga;
+    delete reference;
+}
+
+// Fills Chip Ram of both machines with the same pseudo-random pattern
+- (void)randomizeChipRam:(unsigned)seed {
+
+    srand(seed);
+    for (size_t i = 0; i < amiga->mem.getConfig().chipSize; i++) {
+        amiga->mem.chip[i] = reference->mem.chip[i] = (uint8_t)rand();
+    }
+    amiga->mem.dataBus = reference->mem.dataBus = 0x1234;
+}
+
+- (void)assertLineBlit:(const LineBlit &)blit {
+
+    runLineBlit(amiga, blit);
+    LineResult result = lineResult(amiga);
+    LineResult expected = referenceLineBlit(reference, blit);
+
+    XCTAssertEqual(memcmp(amiga->mem.chip, reference->mem.chip,
+                          amiga->mem.getConfig().chipSize), 0);
+    XCTAssertEqual(result.bltcon0, expected.bltcon0);
+    XCTAssertEqual(result.bltcon1, expected.bltcon1);
+    XCTAssertEqual(result.bltapt, expected.bltapt);
+    XCTAssertEqual(result.bltcpt, expected.bltcpt);
+    XCTAssertEqual(result.bltdpt, expected.bltdpt);
+    XCTAssertEqual(result.bnew, expected.bnew);
+    XCTAssertEqual(result.bzero, expected.bzero);
+    XCTAssertEqual(result.dataBus, expected.dataBus);
+}
+
+// Checks that the cached line blitter matches the per-pixel reference
+- (void)testLineBlitWordCache {
+
+    const uint8_t minterms[] = { 0xCA, 0x4A, 0xEA, 0x0A, 0xF0, 0x00 };
+
+    for (unsigned seed = 0; seed < 64; seed++) {
+
+        [self randomizeChipRam:seed];
+
+        for (int i = 0; i < 32; i++) {
+
+            int x0 = rand() % 320, y0 = rand() % 256;
+            int x1 = rand() % 320, y1 = rand() % 256;
+
+            // Keep short and horizontal lines, they exercise the cache most
+            if (i & 1) { x1 = x0 + rand() % 48 - 24; y1 = y0 + rand() % 3 - 1; }
+            x1 = MAX(0, MIN(319, x1));
+            y1 = MAX(0, MIN(255, y1));
+
+            LineBlit blit = lineBlit(0x10000, x0, y0, x1, y1);
+
+            // Vary the minterm, the texture, single dot mode, and channel C
+            blit.bltcon0 = (blit.bltcon0 & 0xFF00) | minterms[rand() % 6];
+            if (rand() & 1) blit.bdat = (uint16_t)rand();
+            if (rand() & 1) blit.bltcon1 |= 0x0002;
+            if (rand() % 8 == 0) blit.bltcon0 &= ~0x0200;
+            blit.bltcon1 |= (rand() & 0xF) << 12;
+            blit.cdat = (uint16_t)rand();
+
+            [self assertLineBlit:blit];
+        }
+    }
+}
+
+// Measures the time needed to draw the outlines of a polygon scene
+- (void)testLineBlitPerformance {
+
+    const int edges = 3 * 256;
+    std::vector<int> x(edges), y(edges);
+
+    srand(42);
+    for (int i = 0; i < edges; i++) { x[i] = rand() % 320; y[i] = rand() % 256; }
+
+    [self measureBlock:^{
+
+        for (int frame = 0; frame < 10; frame++) {
+            for (int i = 0; i < edges; i += 3) {
+                runLineBlit(self->amiga, lineBlit(0x10000, x[i], y[i], x[i+1], y[i+1]));
+                runLineBlit(self->amiga, lineBlit(0x10000, x[i+1], y[i+1], x[i+2], y[i+2]));
+                runLineBlit(self->amiga, lineBlit(0x10000, x[i+2], y[i+2], x[i], y[i]));
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,567 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "Amiga.h"
+
+#include <algorithm>
+#include <vector>
+
+// Depth values of playfield pixels with different priorities
+static const uint16_t playfieldDepth[] = {
+
+    0,
+    Denise::Z_0 | Denise::Z_PF1,
+    Denise::Z_1 | Denise::Z_PF2,
+    Denise::Z_2 | Denise::Z_PF1,
+    Denise::Z_3 | Denise::Z_PF2,
+    Denise::Z_4 | Denise::Z_PF1 | Denise::Z_PF2
+};
+
+// Creates an Amiga with sprite drawing enabled
+static Amiga *
+makeAmiga()
+{
+    Amiga *amiga = new Amiga();
+
+    amiga->denise.setEmulateSprites(true);
+
+    return amiga;
+}
+
+// Returns a horizontal sprite position inside the visible area
+static uint16_t
+randomSprpos()
+{
+    return (uint16_t)((rand() & 0xFF00) | (0x20 + rand() % 0xC0));
+}
+
+/* Sets up the sprite state of a rasterline from a seed
+ * The line contains playfield pixels with varying priorities, random sprite
+ * data, pixels left over from the previous line, and up to 'changes' writes
+ * into the sprite registers.
+ */
+static void
+randomizeLine(Denise &denise, unsigned seed, int changes, bool attach)
+{
+    srand(seed);
+
+    for (size_t i = 0; i < sizeof(denise.mBuffer); i++) {
+        denise.mBuffer[i] = rand() & 0x0F;
+        denise.zBuffer[i] = playfieldDepth[rand() % 6];
+    }
+
+    for (int s = 0; s < 8; s++) {
+
+        denise.initialSprdata[s] = (uint16_t)rand();
+        denise.initialSprdatb[s] = (uint16_t)rand();
+        denise.initialSprpos[s] = randomSprpos();
+        denise.initialSprctl[s] = rand() & 1;
+        denise.ssra[s] = rand() % 4 ? 0 : (uint16_t)rand();
+        denise.ssrb[s] = rand() % 4 ? 0 : (uint16_t)rand();
+    }
+
+    denise.attach = attach ? 0b10101010 : 0;
+    denise.initialArmed = (uint8_t)rand();
+    denise.wasArmed = 0xFF;
+    denise.spriteClipBegin = (PixelPos)(rand() % 128);
+    denise.spriteClipEnd = (PixelPos)(HPIXELS - rand() % 128);
+
+    denise.sprRegChanges.clear();
+    for (int i = 0; i < changes; i++) {
+
+        int64_t trigger = 4 * (rand() % HPOS_CNT);
+        int s = rand() % 8;
+
+        switch (rand() % 4) {
+
+            case 0:
+                denise.sprRegChanges.add(trigger, REG_SPR0DATA + s, (uint16_t)rand());
+                break;
+            case 1:
+                denise.sprRegChanges.add(trigger, REG_SPR0DATB + s, (uint16_t)rand());
+                break;
+            case 2:
+                denise.sprRegChanges.add(trigger, REG_SPR0POS + s, randomSprpos());
+                break;
+            case 3:
+                denise.sprRegChanges.add(trigger, REG_SPR0CTL + s, rand() & 1);
+                break;
+        }
+    }
+}
+
+/* Sets up a rasterline in which every sprite is reloaded before its previous
+ * contents have been shifted out completely.
+ */
+static void
+reloadLine(Denise &denise, unsigned seed, bool attach)
+{
+    randomizeLine(denise, seed, 0, attach);
+
+    denise.initialArmed = 0xFF;
+
+    for (int s = 0; s < 8; s++) {
+
+        int start = 0x30 + 0x10 * s + rand() % 8;
+        denise.initialSprpos[s] = (uint16_t)start;
+        denise.initialSprctl[s] = 0;
+
+        // Move the sprite to the right while it is drawn and reload it
+        int restart = start + 1 + rand() % 7;
+        int64_t trigger = 4 * (start + 1);
+
+        denise.sprRegChanges.add(trigger, REG_SPR0POS + s, (uint16_t)restart);
+        denise.sprRegChanges.add(trigger, REG_SPR0DATB + s, (uint16_t)rand());
+        denise.sprRegChanges.add(trigger, REG_SPR0DATA + s, (uint16_t)rand());
+    }
+}
+
+// Draws a sprite pixel in the way the shift register model did
+static void
+referenceSpritePixel(Denise &denise, int x, int hpos)
+{
+    uint8_t col = (denise.ssra[x] >> 15) | ((denise.ssrb[x] >> 14) & 2);
+
+    if (col) {
+
+        uint16_t z = Denise::Z_SP[x];
+        int base = 16 + 2 * (x & 6);
+
+        if (z > denise.zBuffer[hpos]) denise.mBuffer[hpos] = base | col;
+        if (z > denise.zBuffer[hpos + 1]) denise.mBuffer[hpos + 1] = base | col;
+        denise.zBuffer[hpos] |= z;
+        denise.zBuffer[hpos + 1] |= z;
+    }
+}
+
+// Draws a pixel of an attached sprite pair in the way the shift register model did
+static void
+referenceAttachedPixel(Denise &denise, int x, int hpos)
+{
+    uint8_t col =
+    (denise.ssra[x-1] >> 15) | ((denise.ssrb[x-1] >> 14) & 2) |
+    ((denise.ssra[x] >> 13) & 4) | ((denise.ssrb[x] >> 12) & 8);
+
+    if (col) {
+
+        uint16_t z = Denise::Z_SP[x];
+
+        if (z > denise.zBuffer[hpos]) {
+            denise.mBuffer[hpos] = 0b10000 | col;
+            denise.zBuffer[hpos] |= z;
+        }
+        if (z > denise.zBuffer[hpos - 1]) {
+            denise.mBuffer[hpos - 1] = 0b10000 | col;
+            denise.zBuffer[hpos - 1] |= z;
+        }
+    }
+}
+
+/* Draws a sprite pair with the per-pixel shift register model
+ * This is the algorithm the span based sprite renderer replaced. It shifts
+ * the serial shift registers once per pixel and reloads them whenever the
+ * beam reaches the start position of an armed sprite.
+ */
+static void
+referenceSpritePair(Denise &denise, int x)
+{
+    uint16_t data1 = denise.initialSprdata[x-1];
+    uint16_t data2 = denise.initialSprdata[x];
+    uint16_t datb1 = denise.initialSprdatb[x-1];
+    uint16_t datb2 = denise.initialSprdatb[x];
+    uint16_t sprpos1 = denise.initialSprpos[x-1];
+    uint16_t sprpos2 = denise.initialSprpos[x];
+    uint16_t sprctl1 = denise.initialSprctl[x-1];
+    uint16_t sprctl2 = denise.initialSprctl[x];
+    int strt1 = 2 + 2 * Denise::sprhpos(sprpos1, sprctl1);
+    int strt2 = 2 + 2 * Denise::sprhpos(sprpos2, sprctl2);
+    bool armed1 = GET_BIT(denise.initialArmed, x-1);
+    bool armed2 = GET_BIT(denise.initialArmed, x);
+    bool at = denise.attached(x);
+    uint16_t *ssra = denise.ssra;
+    uint16_t *ssrb = denise.ssrb;
+
+    auto draw = [&](int hstrt, int hstop) {
+
+        for (int hpos = hstrt; hpos < hstop; hpos += 2) {
+
+            if (hpos == strt1 && armed1) { ssra[x-1] = data1; ssrb[x-1] = datb1; }
+            if (hpos == strt2 && armed2) { ssra[x] = data2; ssrb[x] = datb2; }
+
+            if (ssra[x-1] | ssrb[x-1] | ssra[x] | ssrb[x]) {
+
+                if (hpos >= denise.spriteClipBegin && hpos < denise.spriteClipEnd) {
+                    if (at) {
+                        referenceAttachedPixel(denise, x, hpos);
+                    } else {
+                        referenceSpritePixel(denise, x - 1, hpos);
+                        referenceSpritePixel(denise, x, hpos);
+                    }
+                }
+                ssra[x-1] <<= 1;
+                ssrb[x-1] <<= 1;
+                ssra[x] <<= 1;
+                ssrb[x] <<= 1;
+            }
+        }
+    };
+
+    ChangeRecorder<128> &changes = denise.sprRegChanges;
+    int strt = 0;
+
+    for (int i = changes.begin(); i != changes.end(); i = changes.next(i)) {
+
+        Change &change = changes.change[i];
+        int reg = (int)change.addr;
+
+        draw(strt, (int)change.trigger);
+        strt = (int)change.trigger;
+
+        if (reg == REG_SPR0DATA + x - 1) { data1 = change.value; armed1 = true; }
+        if (reg == REG_SPR0DATA + x) { data2 = change.value; armed2 = true; }
+        if (reg == REG_SPR0DATB + x - 1) { datb1 = change.value; }
+        if (reg == REG_SPR0DATB + x) { datb2 = change.value; }
+        if (reg == REG_SPR0POS + x - 1) { sprpos1 = change.value; }
+        if (reg == REG_SPR0POS + x) { sprpos2 = change.value; }
+        if (reg == REG_SPR0CTL + x - 1) { sprctl1 = change.value; armed1 = false; }
+        if (reg == REG_SPR0CTL + x) { sprctl2 = change.value; armed2 = false; }
+
+        strt1 = 2 + 2 * Denise::sprhpos(sprpos1, sprctl1);
+        strt2 = 2 + 2 * Denise::sprhpos(sprpos2, sprctl2);
+    }
+
+    draw(strt, sizeof(denise.mBuffer) - 1);
+}
+
+// Draws all sprites with the per-pixel shift register model
+static void
+referenceSprites(Denise &denise)
+{
+    referenceSpritePair(denise, 7);
+    referenceSpritePair(denise, 5);
+    referenceSpritePair(denise, 3);
+    referenceSpritePair(denise, 1);
+
+    denise.sprRegChanges.clear();
+}
+
+/* Computes the color register index and the depth value of a playfield pixel
+ * from its six bitplane bits.
+ */
+static void
+referencePixel(uint8_t s, bool dual, uint16_t bplcon2, uint8_t &index, uint16_t &depth)
+{
+    uint16_t prio1 = Denise::zPF1(bplcon2);
+    uint16_t prio2 = Denise::zPF2(bplcon2);
+
+    if (!dual) {
+
+        index = prio2 ? s : (s & 16) ? 16 : s;
+        depth = prio2 && s ? prio2 : 0;
+        return;
+    }
+
+    uint8_t index1 = (s & 1) | ((s & 4) >> 1) | ((s & 16) >> 2);
+    uint8_t index2 = ((s & 2) >> 1) | ((s & 8) >> 2) | ((s & 32) >> 3);
+    uint8_t color1 = prio1 ? index1 : 0;
+    uint8_t color2 = prio2 ? (index2 | 0b1000) : 0;
+    bool front2 = Denise::PF2PRI(bplcon2);
+
+    if (index1 && index2) {
+        index = front2 ? color2 : color1;
+        depth = (front2 ? prio2 : prio1) | Denise::Z_DPF | Denise::Z_PF1 | Denise::Z_PF2;
+    } else if (index1) {
+        index = color1;
+        depth = prio1 | Denise::Z_DPF | Denise::Z_PF1;
+    } else if (index2) {
+        index = color2;
+        depth = prio2 | Denise::Z_DPF | Denise::Z_PF2;
+    } else {
+        index = 0;
+        depth = Denise::Z_DPF;
+    }
+}
+
+// Fills the bitplane buffer with random pixels
+static void
+randomizeBitplanes(Denise &denise, unsigned seed)
+{
+    srand(seed);
+
+    for (size_t i = 0; i < sizeof(denise.bBuffer); i++) {
+        denise.bBuffer[i] = rand() & 0x3F;
+    }
+}
+
+@interface DeniseTests : XCTestCase
+
+@end
+
+@implementation DeniseTests {
+
+    Amiga *amiga;
+    Amiga *reference;
+}
+
+- (void)setUp {
+
+    amiga = makeAmiga();
+    reference = makeAmiga();
+}
+
+- (void)tearDown {
+
+    delete amiga;
+    delete reference;
+}
+
+// Compares the sprite output of both machines
+- (void)assertSameSprites {
+
+    Denise &d1 = amiga->denise;
+    Denise &d2 = reference->denise;
+
+    XCTAssertEqual(memcmp(d1.mBuffer, d2.mBuffer, sizeof(d1.mBuffer)), 0);
+    XCTAssertEqual(memcmp(d1.zBuffer, d2.zBuffer, sizeof(d1.zBuffer)), 0);
+    XCTAssertEqual(memcmp(d1.ssra, d2.ssra, sizeof(d1.ssra)), 0);
+    XCTAssertEqual(memcmp(d1.ssrb, d2.ssrb, sizeof(d1.ssrb)), 0);
+}
+
+// Checks that the span renderer matches the shift register model
+- (void)testSpriteSpans {
+
+    for (unsigned seed = 0; seed < 256; seed++) {
+
+        bool attach = seed & 1;
+
+        randomizeLine(amiga->denise, seed, seed % 32, attach);
+        randomizeLine(reference->denise, seed, seed % 32, attach);
+
+        amiga->denise.drawSprites();
+        referenceSprites(reference->denise);
+
+        [self assertSameSprites];
+    }
+}
+
+// Checks sprites that are reloaded while their previous data is shifted out
+- (void)testSpriteReloads {
+
+    for (unsigned seed = 0; seed < 64; seed++) {
+
+        bool attach = seed & 1;
+
+        reloadLine(amiga->denise, seed, attach);
+        reloadLine(reference->denise, seed, attach);
+
+        amiga->denise.drawSprites();
+        referenceSprites(reference->denise);
+
+        [self assertSameSprites];
+    }
+}
+
+// Checks that pixels left over at the end of a line are drawn in the next one
+- (void)testSpriteResidue {
+
+    for (unsigned seed = 0; seed < 64; seed++) {
+
+        bool attach = seed & 1;
+
+        // Place all sprites so close to the end of the line that they overflow
+        randomizeLine(amiga->denise, seed, 0, attach);
+        randomizeLine(reference->denise, seed, 0, attach);
+        for (int s = 0; s < 8; s++) {
+            amiga->denise.initialSprpos[s] = reference->denise.initialSprpos[s] = 0xF0 + s;
+        }
+        amiga->denise.initialArmed = reference->denise.initialArmed = 0xFF;
+
+        amiga->denise.drawSprites();
+        referenceSprites(reference->denise);
+        [self assertSameSprites];
+
+        // Draw the next line without any sprite being armed
+        std::vector<uint16_t> ssra(amiga->denise.ssra, amiga->denise.ssra + 8);
+        std::vector<uint16_t> ssrb(amiga->denise.ssrb, amiga->denise.ssrb + 8);
+
+        randomizeLine(amiga->denise, seed + 1000, 0, attach);
+        randomizeLine(reference->denise, seed + 1000, 0, attach);
+        amiga->denise.initialArmed = reference->denise.initialArmed = 0;
+        for (int s = 0; s < 8; s++) {
+            amiga->denise.ssra[s] = reference->denise.ssra[s] = ssra[s];
+            amiga->denise.ssrb[s] = reference->denise.ssrb[s] = ssrb[s];
+        }
+
+        amiga->denise.drawSprites();
+        referenceSprites(reference->denise);
+        [self assertSameSprites];
+    }
+}
+
+/* Measures the time needed to draw the sprites of a multiplexed scene
+ * All eight sprites are armed in every line and each of them is reused
+ * several times per line, which is common in games and demos.
+ */
+- (void)testSpritePerformance {
+
+    std::vector<Change> changes;
+
+    srand(42);
+    for (int s = 0; s < 8; s++) {
+        for (int i = 0; i < 4; i++) {
+
+            int start = 0x30 + 0x30 * i + 4 * s;
+            int64_t trigger = 4 * (start - 2);
+
+            changes.push_back(Change(trigger, REG_SPR0POS + s, (uint16_t)start));
+            changes.push_back(Change(trigger, REG_SPR0DATB + s, (uint16_t)rand()));
+            changes.push_back(Change(trigger, REG_SPR0DATA + s, (uint16_t)rand()));
+        }
+    }
+
+    // Register writes are recorded in the order they happen
+    std::stable_sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.trigger < b.trigger;
+    });
+
+    randomizeLine(amiga->denise, 0, 0, false);
+    amiga->denise.spriteClipBegin = 0;
+    amiga->denise.spriteClipEnd = HPIXELS;
+
+    [self measureBlock:^{
+
+        Denise &denise = self->amiga->denise;
+
+        for (int line = 0; line < 50 * VPOS_CNT; line++) {
+
+            denise.attach = (line & 1) ? 0b10100000 : 0;
+            denise.initialArmed = 0;
+            denise.wasArmed = 0xFF;
+            for (const Change &change : changes) {
+                denise.sprRegChanges.add(change.trigger, change.addr, change.value);
+            }
+            denise.drawSprites();
+        }
+    }];
+}
+
+// Checks the translated playfield pixels for all priority settings
+- (void)testTranslate {
+
+    Denise &denise = amiga->denise;
+
+    for (unsigned seed = 0; seed < 256; seed++) {
+
+        bool dual = seed & 1;
+        uint16_t bplcon2 = (uint16_t)(seed >> 1);
+
+        randomizeBitplanes(denise, seed);
+        denise.initialBplcon0 = dual ? 0x0400 : 0;
+        denise.initialBplcon2 = bplcon2;
+        denise.translate();
+
+        for (size_t i = 0; i < sizeof(denise.bBuffer); i++) {
+
+            uint8_t index;
+            uint16_t depth;
+
+            referencePixel(denise.bBuffer[i], dual, bplcon2, index, depth);
+            XCTAssertEqual(denise.iBuffer[i], index);
+            XCTAssertEqual(denise.mBuffer[i], index);
+            XCTAssertEqual(denise.zBuffer[i], depth);
+        }
+    }
+}
+
+// Checks the translated playfield pixels if BPLCON0 and BPLCON2 change
+- (void)testTranslateChanges {
+
+    Denise &denise = amiga->denise;
+
+    for (unsigned seed = 0; seed < 64; seed++) {
+
+        randomizeBitplanes(denise, seed);
+        denise.initialBplcon0 = (seed & 1) ? 0x0400 : 0;
+        denise.initialBplcon2 = rand() & 0x7F;
+
+        // Record register changes at arbitrary pixel positions
+        std::vector<Change> changes;
+        for (int i = 0; i < 8; i++) {
+
+            int64_t trigger = rand() % sizeof(denise.bBuffer);
+            uint32_t addr = (rand() & 1) ? REG_BPLCON0_DENISE : REG_BPLCON2;
+            uint16_t value = addr == REG_BPLCON2 ? rand() & 0x7F : (rand() & 1) << 10;
+            changes.push_back(Change(trigger, addr, value));
+        }
+        std::stable_sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+            return a.trigger < b.trigger;
+        });
+        for (const Change &change : changes) {
+            denise.conRegChanges.add(change.trigger, change.addr, change.value);
+        }
+
+        denise.translate();
+
+        bool dual = Denise::dbplf(denise.initialBplcon0);
+        uint16_t bplcon2 = denise.initialBplcon2;
+        size_t next = 0;
+
+        for (size_t i = 0; i < sizeof(denise.bBuffer); i++) {
+
+            for (; next < changes.size() && changes[next].trigger == (int64_t)i; next++) {
+                if (changes[next].addr == REG_BPLCON2) {
+                    bplcon2 = changes[next].value;
+                } else {
+                    dual = Denise::dbplf(changes[next].value);
+                }
+            }
+
+            uint8_t index;
+            uint16_t depth;
+
+            referencePixel(denise.bBuffer[i], dual, bplcon2, index, depth);
+            XCTAssertEqual(denise.iBuffer[i], index);
+            XCTAssertEqual(denise.mBuffer[i], index);
+            XCTAssertEqual(denise.zBuffer[i], depth);
+        }
+    }
+}
+
+// Measures the time needed to translate one second of single-playfield lines
+- (void)testTranslateSPFPerformance {
+
+    randomizeBitplanes(amiga->denise, 0);
+    amiga->denise.initialBplcon0 = 0;
+    amiga->denise.initialBplcon2 = 0x24;
+
+    [self measureBlock:^{
+
+        for (int line = 0; line < 50 * VPOS_CNT; line++) {
+            self->amiga->denise.translate();
+        }
+    }];
+}
+
+// Measures the time needed to translate one second of dual-playfield lines
+- (void)testTranslateDPFPerformance {
+
+    randomizeBitplanes(amiga->denise, 0);
+    amiga->denise.initialBplcon0 = 0x0400;
+    amiga->denise.initialBplcon2 = 0x24;
+
+    [self measureBlock:^{
+
+        for (int line = 0; line < 50 * VPOS_CNT; line++) {
+            self->amiga->denise.translate();
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,95 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "Amiga.h"
+
+#include <algorithm>
+
+// Number of opacity values between 0.0 and 1.0 that are checked
+static const int steps = 1000;
+
+// Returns a pair of random RGBA pixels
+static uint64_t
+randomPixels()
+{
+    return ((uint64_t)rand() << 48) ^ ((uint64_t)rand() << 24) ^ (uint64_t)rand();
+}
+
+// Returns the i-th pixel of a pair of RGBA pixels
+static GpuColor
+pixel(uint64_t pixels, int i)
+{
+    return GpuColor((uint32_t)(pixels >> (32 * i)));
+}
+
+// Returns the largest deviation of a pair of pixels from the expected colors
+static int
+deviation(uint64_t pixels, GpuColor expected0, GpuColor expected1)
+{
+    int result = 0;
+
+    for (int i = 0; i < 2; i++) {
+
+        uint32_t value = pixel(pixels, i).rawValue;
+        uint32_t expected = (i ? expected1 : expected0).rawValue;
+
+        for (int shift = 0; shift < 32; shift += 8) {
+
+            int delta = (int)((value >> shift) & 0xFF) - (int)((expected >> shift) & 0xFF);
+            result = std::max(result, abs(delta));
+        }
+    }
+    return result;
+}
+
+@interface DmaDebuggerTests : XCTestCase
+
+@end
+
+@implementation DmaDebuggerTests
+
+// Checks that darkening the background matches GpuColor::shade()
+- (void)testBlendShade {
+
+    srand(42);
+    for (int i = 0; i <= steps; i++) {
+
+        double weight = (double)i / steps;
+        uint64_t scale = 256 - (uint64_t)(weight * 256.0 + 0.5);
+        uint64_t bg = randomPixels();
+
+        uint64_t result = DmaDebugger::blend(0, bg, 0, scale);
+
+        GpuColor expected0 = pixel(bg, 0).shade(weight);
+        GpuColor expected1 = pixel(bg, 1).shade(weight);
+        XCTAssertLessThanOrEqual(deviation(result, expected0, expected1), 1);
+    }
+}
+
+// Checks that mixing the foreground with the background matches GpuColor::mix()
+- (void)testBlendMix {
+
+    srand(42);
+    for (int i = 0; i <= steps; i++) {
+
+        double weight = (double)i / steps;
+        uint64_t scale = (uint64_t)(weight * 256.0 + 0.5);
+        uint64_t fg = randomPixels();
+        uint64_t bg = randomPixels();
+
+        uint64_t result = DmaDebugger::blend(fg, bg, 256 - scale, scale);
+
+        GpuColor expected0 = pixel(fg, 0).mix(RgbColor(pixel(bg, 0)), weight);
+        GpuColor expected1 = pixel(fg, 1).mix(RgbColor(pixel(bg, 1)), weight);
+        XCTAssertLessThanOrEqual(deviation(result, expected0, expected1), 1);
+    }
+}
+
+@end
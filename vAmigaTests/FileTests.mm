@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the GNU General Public License v3
+//
+// See https://www.gnu.org for license information
+// -----------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "Amiga.h"
+
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Number of disk images in the test directory
+static const int adfCount = 64;
+
+// Returns the contents of the i-th disk image
+static std::vector<uint8_t>
+adfContents(int i)
+{
+    std::vector<uint8_t> data(ADFSIZE_35_DD);
+
+    for (size_t j = 0; j < data.size(); j++) {
+        data[j] = (uint8_t)(j * 31 + i * 7 + (j >> 9));
+    }
+    return data;
+}
+
+@interface FileTests : XCTestCase
+
+@end
+
+@implementation FileTests {
+
+    std::string dir;
+    std::vector<std::string> paths;
+}
+
+// Creates a temporary directory holding a number of DD disk images
+- (void)setUp {
+
+    const char *tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp ? tmp : "/tmp") + "/vAmigaADF.XXXXXX";
+    std::vector<char> name(pattern.begin(), pattern.end());
+    name.push_back(0);
+
+    XCTAssertNotEqual(mkdtemp(name.data()), (char *)NULL);
+    dir = name.data();
+
+    for (int i = 0; i < adfCount; i++) {
+
+        std::string path = dir + "/disk" + std::to_string(i) + ".adf";
+        std::vector<uint8_t> data = adfContents(i);
+
+        FILE *file = fopen(path.c_str(), "wb");
+        XCTAssertNotEqual(file, (FILE *)NULL);
+        XCTAssertEqual(fwrite(data.data(), 1, data.size(), file), data.size());
+        fclose(file);
+
+        paths.push_back(path);
+    }
+}
+
+- (void)tearDown {
+
+    for (const std::string &path : paths) unlink(path.c_str());
+    rmdir(dir.c_str());
+}
+
+// Checks that the loaded disk images match the files on disk
+- (void)testADFLoadContents {
+
+    std::vector<uint8_t> buffer(ADFSIZE_35_DD);
+
+    for (int i = 0; i < adfCount; i++) {
+
+        ADFFile *adf = ADFFile::makeWithFile(paths[i].c_str());
+        XCTAssertNotEqual(adf, (ADFFile *)NULL);
+        if (!adf) continue;
+
+        XCTAssertEqual(adf->getDiskType(), DISK_35_DD);
+        XCTAssertEqual(adf->writeToBuffer(buffer.data()), (size_t)ADFSIZE_35_DD);
+        XCTAssertTrue(buffer == adfContents(i));
+        delete adf;
+    }
+}
+
+// Measures the time needed to load all disk images in the directory
+- (void)testADFLoadPerformance {
+
+    [self measureBlock:^{
+
+        for (const std::string &path : self->paths) {
+
+            ADFFile *adf = ADFFile::makeWithFile(path.c_str());
+            XCTAssertNotEqual(adf, (ADFFile *)NULL);
+            delete adf;
+        }
+    }];
+}
+
+@end